@@ -23,17 +23,21 @@ namespace eez {
 namespace psu {
 namespace board {
 
-void powerUp() {
+void powerUpSoftStart() {
     digitalWrite(PWR_SSTART, HIGH);
-    delay(700);
+}
 
+void powerUpDirect() {
     digitalWrite(PWR_DIRECT, HIGH);
-    delay(100);
+}
 
+void powerUpFinish() {
     digitalWrite(PWR_SSTART, LOW);
 }
 
 void powerDown() {
+    // power down could also happen in the middle of power up
+    digitalWrite(PWR_SSTART, LOW);
     digitalWrite(PWR_DIRECT, LOW);
 }
 
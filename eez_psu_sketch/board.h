@@ -22,7 +22,17 @@ namespace eez {
 namespace psu {
 namespace board {
 
-void powerUp();
+/// Time in milliseconds from the soft start to the direct power on.
+static const unsigned long POWER_UP_SOFT_START_MS = 700;
+/// Time in milliseconds from the direct power on to the end of soft start.
+static const unsigned long POWER_UP_DIRECT_MS = 100;
+
+/// Power up is done in three steps, the caller must wait
+/// POWER_UP_SOFT_START_MS and POWER_UP_DIRECT_MS between them.
+void powerUpSoftStart();
+void powerUpDirect();
+void powerUpFinish();
+
 void powerDown();
 
 void cvLedSwitch(Channel *channel, bool on);
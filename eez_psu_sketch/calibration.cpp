@@ -153,7 +153,7 @@ void start(Channel *channel_) {
     current.reset();
     voltage.reset();
 
-    channel->flags.cal_enabled = 0;
+    channel->calibrationEnable(false);
 
     resetChannelToZero();
 
@@ -166,7 +166,7 @@ void stop() {
     enabled = false;
 
     if (channel->isCalibrationExists()) {
-        channel->flags.cal_enabled = 1;
+        channel->calibrationEnable(true);
     }
 
     resetChannelToZero();
@@ -245,7 +245,7 @@ bool save() {
 
 bool clear() {
     channel->clearCalibrationConf();
-    channel->flags.cal_enabled = 0;
+    channel->calibrationEnable(false);
     return persist_conf::saveChannelCalibration(channel);
 }
 
@@ -53,6 +53,10 @@ void Channel::Value::init(float def_step) {
     mon_dac = 0;
     mon = 0;
     step = def_step;
+#if CONF_FIXED_POINT_ADC
+    mon_dac_q16 = 0;
+    mon_q16 = 0;
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -103,11 +107,25 @@ Channel::Channel(
     OPP_DEFAULT_STATE(OPP_DEFAULT_STATE_), OPP_MIN_DELAY(OPP_MIN_DELAY_), OPP_DEFAULT_DELAY(OPP_DEFAULT_DELAY_), OPP_MAX_DELAY(OPP_MAX_DELAY_), OPP_MIN_LEVEL(OPP_MIN_LEVEL_), OPP_DEFAULT_LEVEL(OPP_DEFAULT_LEVEL_), OPP_MAX_LEVEL(OPP_MAX_LEVEL_),
     ioexp(*this),
     adc(*this),
-    dac(*this)
+    dac(*this),
+    adc_read_pending(0),
+    adc_events_head(0),
+    adc_events_tail(0),
+    adc_events_dropped(0),
+    adc_event_time(0),
+    output_disabled_time(0),
+    prot_log_head(0),
+    prot_log_size(0),
+    history_head(0),
+    history_size(0),
+    history_frozen(false)
 {
+    onCalibrationChanged();
 }
 
-void Channel::protectionEnter(ProtectionValue &cpv) {
+void Channel::protectionEnter(ProtectionValue &cpv, uint32_t delay_usec) {
+    uint32_t trip = micros();
+
     outputEnable(false);
 
     cpv.flags.tripped = 1;
@@ -115,23 +133,88 @@ void Channel::protectionEnter(ProtectionValue &cpv) {
     int bit_mask = reg_get_ques_isum_bit_mask_for_channel_protection_value(this, cpv);
     setQuesBits(bit_mask, true);
 
+    uint8_t type = IS_OVP_VALUE(this, cpv) ? PROTECTION_EVENT_OVP : IS_OCP_VALUE(this, cpv) ? PROTECTION_EVENT_OCP : PROTECTION_EVENT_OPP;
+    logProtectionEvent(type, cpv.alarm_started, cpv.alarm_processed, trip, micros(), delay_usec);
+
     sound::playBeep();
 }
 
+#if CONF_FIXED_POINT_ADC
+
+/// 0.01 in Q16.16
+#define PROT_DIFF_Q16 655
+
+/// Q16.16 difference in mV or mA, for debug traces.
+static int diffToMilli(int32_t diff_q16) {
+    return (int)(((int64_t)diff_q16 * 1000) >> 16);
+}
+
+void Channel::updateProtectionThresholds() {
+    ProtectionThresholds thresholds;
+
+    thresholds.u_set = util::floatToQ16(u.set);
+    thresholds.i_set = util::floatToQ16(i.set);
+    thresholds.p_level = util::floatToQ16(prot_conf.p_level);
+
+    float delay = prot_conf.u_delay - PROT_DELAY_CORRECTION;
+    thresholds.u_delay_usec = delay > 0 ? (uint32_t)(delay * 1000000UL) : 0;
+    delay = prot_conf.i_delay - PROT_DELAY_CORRECTION;
+    thresholds.i_delay_usec = delay > 0 ? (uint32_t)(delay * 1000000UL) : 0;
+    delay = prot_conf.p_delay;
+    thresholds.p_delay_usec = delay > 0 ? (uint32_t)(delay * 1000000UL) : 0;
+
+    noInterrupts();
+    prot_thresholds = thresholds;
+    interrupts();
+}
+
+#else
+
+/// Difference in mV or mA, for debug traces.
+static int diffToMilli(float diff) {
+    return (int)(diff * 1000);
+}
+
+#endif
+
 void Channel::protectionCheck(ProtectionValue &cpv) {
     bool state;
     bool condition;
+    uint32_t delay_usec;
+
+#if CONF_FIXED_POINT_ADC
+    int32_t i_diff = labs(i.mon_q16 - prot_thresholds.i_set);
+    int32_t u_diff = labs(u.mon_q16 - prot_thresholds.u_set);
+
+    if (IS_OVP_VALUE(this, cpv)) {
+        state = prot_conf.flags.u_state;
+        condition = flags.cv_mode && (!flags.cc_mode || i_diff >= PROT_DIFF_Q16);
+        delay_usec = prot_thresholds.u_delay_usec;
+    }
+    else if (IS_OCP_VALUE(this, cpv)) {
+        state = prot_conf.flags.i_state;
+        condition = flags.cc_mode && (!flags.cv_mode || u_diff >= PROT_DIFF_Q16);
+        delay_usec = prot_thresholds.i_delay_usec;
+    }
+    else {
+        state = prot_conf.flags.p_state;
+        condition = (int32_t)(((int64_t)u.mon_q16 * i.mon_q16) >> 16) > prot_thresholds.p_level;
+        delay_usec = prot_thresholds.p_delay_usec;
+    }
+#else
     float delay;
+    float i_diff = fabs(i.mon - i.set);
+    float u_diff = fabs(u.mon - u.set);
 
     if (IS_OVP_VALUE(this, cpv)) {
         state = prot_conf.flags.u_state;
-        condition = flags.cv_mode && (!flags.cc_mode || fabs(i.mon - i.set) >= 0.01);
+        condition = flags.cv_mode && (!flags.cc_mode || i_diff >= 0.01);
         delay = prot_conf.u_delay;
         delay -= PROT_DELAY_CORRECTION;
     }
     else if (IS_OCP_VALUE(this, cpv)) {
         state = prot_conf.flags.i_state;
-        condition = flags.cc_mode && (!flags.cv_mode || fabs(u.mon - u.set) >= 0.01);
+        condition = flags.cc_mode && (!flags.cv_mode || u_diff >= 0.01);
         delay = prot_conf.i_delay;
         delay -= PROT_DELAY_CORRECTION;
     }
@@ -141,29 +224,35 @@ void Channel::protectionCheck(ProtectionValue &cpv) {
         delay = prot_conf.p_delay;
     }
 
+    delay_usec = delay > 0 ? (uint32_t)(delay * 1000000UL) : 0;
+#endif
+
     if (state && isOutputEnabled() && condition) {
-        if (delay > 0) {
+        if (delay_usec > 0) {
             if (cpv.flags.alarmed) {
-                if (micros() - cpv.alarm_started >= delay * 1000000UL) {
+                if (adc_event_time - cpv.alarm_started >= delay_usec) {
                     cpv.flags.alarmed = 0;
 
                     if (IS_OVP_VALUE(this, cpv)) {
-                        DebugTrace("OVP condition: CV_MODE=%d, CC_MODE=%d, I DIFF=%d mA", (int)flags.cv_mode, (int)flags.cc_mode, (int)(fabs(i.mon - i.set) * 1000));
+                        DebugTrace("OVP condition: CV_MODE=%d, CC_MODE=%d, I DIFF=%d mA", (int)flags.cv_mode, (int)flags.cc_mode, diffToMilli(i_diff));
                     }
                     else if (IS_OCP_VALUE(this, cpv)) {
-                        DebugTrace("OCP condition: CC_MODE=%d, CV_MODE=%d, U DIFF=%d mV", (int)flags.cc_mode, (int)flags.cv_mode, (int)(fabs(u.mon - u.set) * 1000));
+                        DebugTrace("OCP condition: CC_MODE=%d, CV_MODE=%d, U DIFF=%d mV", (int)flags.cc_mode, (int)flags.cv_mode, diffToMilli(u_diff));
                     }
 
-                    protectionEnter(cpv);
+                    protectionEnter(cpv, delay_usec);
                 }
             }
             else {
                 cpv.flags.alarmed = 1;
-                cpv.alarm_started = micros();
+                cpv.alarm_started = adc_event_time;
+                cpv.alarm_processed = micros();
             }
         }
         else {
-            protectionEnter(cpv);
+            cpv.alarm_started = adc_event_time;
+            cpv.alarm_processed = micros();
+            protectionEnter(cpv, 0);
         }
     }
     else {
@@ -215,7 +304,7 @@ void Channel::reset() {
     opp.flags.alarmed = 0;
 
     // CAL:STAT ON if valid calibrating data for both voltage and current exists in the nonvolatile memory, otherwise OFF.
-    flags.cal_enabled = isCalibrationExists();
+    calibrationEnable(isCalibrationExists());
 
     // OUTP:PROT:CLE OFF
     // [SOUR[n]]:VOLT:PROT:TRIP? 0
@@ -257,6 +346,8 @@ void Channel::clearCalibrationConf() {
 
     strcpy(cal_conf.calibration_date, "");
     strcpy(cal_conf.calibration_remark, CALIBRATION_REMARK_INIT);
+
+    onCalibrationChanged();
 }
 
 void Channel::clearProtectionConf() {
@@ -312,9 +403,16 @@ bool Channel::isOk() {
 }
 
 void Channel::tick(unsigned long tick_usec) {
+    processAdcEvents();
+
     ioexp.tick(tick_usec);
     adc.tick(tick_usec);
 
+#if CONF_FIXED_POINT_ADC
+    updateMonValues();
+    updateProtectionThresholds();
+#endif
+
     // turn off DP after delay
     if (delayed_dp_off && tick_usec - delayed_dp_off_start >= DP_OFF_DELAY_PERIOD * 1000000L) {
         delayed_dp_off = false;
@@ -340,25 +438,198 @@ int16_t Channel::remapCurrentToAdcData(float value) {
     return (int16_t)util::clamp(adc_value, (float)(-AnalogDigitalConverter::ADC_MAX - 1), (float)AnalogDigitalConverter::ADC_MAX);
 }
 
-float Channel::readingToCalibratedValue(Value *cv, float mon_reading) {
-    if (flags.cal_enabled) {
-        if (cv == &u) {
-            mon_reading = util::remap(mon_reading, cal_conf.u.min.adc, cal_conf.u.min.val, cal_conf.u.max.adc, cal_conf.u.max.val);
-        }
-        else {
-            mon_reading = util::remap(mon_reading, cal_conf.i.min.adc, cal_conf.i.min.val, cal_conf.i.max.adc, cal_conf.i.max.val);
+int32_t Channel::adcDataToValueQ16(const Value *cv, int16_t adc_data) {
+    return cv->adc_offset_q16 + (int32_t)(((int64_t)adc_data * cv->adc_scale_q32) >> 16);
+}
+
+void Channel::onCalibrationChanged() {
+    for (int k = 0; k < 2; ++k) {
+        Value &cv = k == 0 ? u : i;
+        float min = k == 0 ? U_MIN : I_MIN;
+        float max = k == 0 ? U_MAX : I_MAX;
+        CalibrationValueConfiguration &cal = k == 0 ? cal_conf.u : cal_conf.i;
+
+        // ADC data -> value, i.e. remapAdcDataToVoltage/Current followed by
+        // remap(value, cal.min.adc, cal.min.val, cal.max.adc, cal.max.val)
+        float adc_scale = (max - min) / (AnalogDigitalConverter::ADC_MAX - AnalogDigitalConverter::ADC_MIN);
+        float adc_offset = min - AnalogDigitalConverter::ADC_MIN * adc_scale;
+
+        // value -> DAC data, i.e. remap(value, cal.min.val, cal.min.dac, cal.max.val, cal.max.dac)
+        // followed by remap(value, min, DAC_MIN, max, DAC_MAX)
+        float dac_scale = (DigitalAnalogConverter::DAC_MAX - DigitalAnalogConverter::DAC_MIN) / (max - min);
+        float dac_offset = DigitalAnalogConverter::DAC_MIN - min * dac_scale;
+
+        if (flags.cal_enabled) {
+            float cal_scale = (cal.max.val - cal.min.val) / (cal.max.adc - cal.min.adc);
+            float cal_offset = cal.min.val - cal.min.adc * cal_scale;
+            adc_offset = adc_offset * cal_scale + cal_offset;
+            adc_scale *= cal_scale;
+
+            cal_scale = (cal.max.dac - cal.min.dac) / (cal.max.val - cal.min.val);
+            cal_offset = cal.min.dac - cal.min.val * cal_scale;
+            dac_offset = cal_offset * dac_scale + dac_offset;
+            dac_scale *= cal_scale;
         }
+
+        int32_t adc_scale_q32 = (int32_t)(adc_scale * 4294967296.0f + 0.5f);
+        int32_t adc_offset_q16 = util::floatToQ16(adc_offset);
+
+        noInterrupts();
+        cv.adc_scale = adc_scale;
+        cv.adc_offset = adc_offset;
+        cv.adc_scale_q32 = adc_scale_q32;
+        cv.adc_offset_q16 = adc_offset_q16;
+        interrupts();
+
+        cv.dac_scale = dac_scale;
+        cv.dac_offset = dac_offset;
     }
-    return mon_reading;
 }
 
-void Channel::valueAddReading(Value *cv, float value) {
-    cv->mon = readingToCalibratedValue(cv, value);
+void Channel::valueAddReading(Value *cv, int16_t adc_data) {
+#if CONF_FIXED_POINT_ADC
+    cv->mon_q16 = adcDataToValueQ16(cv, adc_data);
+#else
+    cv->mon = adc_data * cv->adc_scale + cv->adc_offset;
+#endif
     protectionCheck(opp);
 }
 
-void Channel::valueAddReadingDac(Value *cv, float value) {
-    cv->mon_dac = readingToCalibratedValue(cv, value);
+void Channel::valueAddReadingDac(Value *cv, int16_t adc_data) {
+#if CONF_FIXED_POINT_ADC
+    cv->mon_dac_q16 = adcDataToValueQ16(cv, adc_data);
+#else
+    cv->mon_dac = adc_data * cv->adc_scale + cv->adc_offset;
+#endif
+}
+
+#if CONF_FIXED_POINT_ADC
+void Channel::updateMonValues() {
+    noInterrupts();
+    int32_t u_mon = u.mon_q16;
+    int32_t u_mon_dac = u.mon_dac_q16;
+    int32_t i_mon = i.mon_q16;
+    int32_t i_mon_dac = i.mon_dac_q16;
+    interrupts();
+
+    u.mon = util::q16ToFloat(u_mon);
+    u.mon_dac = util::q16ToFloat(u_mon_dac);
+    i.mon = util::q16ToFloat(i_mon);
+    i.mon_dac = util::q16ToFloat(i_mon_dac);
+}
+#endif
+
+#ifdef EEZ_PSU_SIMULATOR
+void Channel::benchmarkAdcConversion(uint32_t iterations, float &remap_ns, float &float_ns, float &fixed_ns) {
+    volatile float float_sum = 0;
+    volatile int32_t fixed_sum = 0;
+
+    // micros() doesn't advance in the virtual time mode
+    uint64_t start = simulator::getRealTime();
+    for (uint32_t n = 0; n < iterations; ++n) {
+        int16_t adc_data = (int16_t)(n & AnalogDigitalConverter::ADC_MAX);
+        float value = remapAdcDataToVoltage(adc_data);
+        if (flags.cal_enabled) {
+            value = util::remap(value, cal_conf.u.min.adc, cal_conf.u.min.val, cal_conf.u.max.adc, cal_conf.u.max.val);
+        }
+        float_sum = float_sum + value;
+    }
+    remap_ns = (simulator::getRealTime() - start) * 1000.0f / iterations;
+
+    start = simulator::getRealTime();
+    for (uint32_t n = 0; n < iterations; ++n) {
+        int16_t adc_data = (int16_t)(n & AnalogDigitalConverter::ADC_MAX);
+        float_sum = float_sum + adc_data * u.adc_scale + u.adc_offset;
+    }
+    float_ns = (simulator::getRealTime() - start) * 1000.0f / iterations;
+
+    start = simulator::getRealTime();
+    for (uint32_t n = 0; n < iterations; ++n) {
+        int16_t adc_data = (int16_t)(n & AnalogDigitalConverter::ADC_MAX);
+        fixed_sum = fixed_sum + adcDataToValueQ16(&u, adc_data);
+    }
+    fixed_ns = (simulator::getRealTime() - start) * 1000.0f / iterations;
+}
+#endif
+
+void Channel::addHistorySample() {
+    if (history_frozen) return;
+
+    Sample &sample = history[history_head];
+    sample.time = adc_event_time;
+#if CONF_FIXED_POINT_ADC
+    sample.u = u.mon_q16;
+    sample.i = i.mon_q16;
+#else
+    sample.u = util::floatToQ16(u.mon);
+    sample.i = util::floatToQ16(i.mon);
+#endif
+
+    if (++history_head == SAMPLE_HISTORY_SIZE) {
+        history_head = 0;
+    }
+    if (history_size < SAMPLE_HISTORY_SIZE) {
+        ++history_size;
+    }
+}
+
+void Channel::freezeHistory(bool freeze) {
+    history_frozen = freeze;
+}
+
+uint16_t Channel::getHistorySize() {
+    noInterrupts();
+    uint16_t size = history_size;
+    interrupts();
+    return size;
+}
+
+const Channel::Sample &Channel::getHistorySample(uint16_t index) {
+    noInterrupts();
+    uint16_t head = history_head;
+    uint16_t size = history_size;
+    interrupts();
+
+    int i = head - size + index;
+    if (i < 0) {
+        i += SAMPLE_HISTORY_SIZE;
+    }
+    return history[i];
+}
+
+void Channel::logProtectionEvent(uint8_t type, uint32_t onset, uint32_t alarm, uint32_t trip, uint32_t reg_set, uint32_t delay) {
+    ProtectionEvent &event = prot_log[prot_log_head];
+    event.type = type;
+    event.onset = onset;
+    event.alarm = alarm;
+    event.trip = trip;
+    event.output_off = output_disabled_time;
+    event.reg_set = reg_set;
+    event.delay = delay;
+
+    if (++prot_log_head == PROTECTION_LOG_SIZE) {
+        prot_log_head = 0;
+    }
+    if (prot_log_size < PROTECTION_LOG_SIZE) {
+        ++prot_log_size;
+    }
+}
+
+uint8_t Channel::getProtectionLogSize() {
+    return prot_log_size;
+}
+
+const Channel::ProtectionEvent &Channel::getProtectionLogEvent(uint8_t index) {
+    int i = prot_log_head - prot_log_size + index;
+    if (i < 0) {
+        i += PROTECTION_LOG_SIZE;
+    }
+    return prot_log[i];
+}
+
+void Channel::clearProtectionLog() {
+    prot_log_head = 0;
+    prot_log_size = 0;
 }
 
 #if CONF_DEBUG
@@ -368,44 +639,55 @@ extern int16_t debug::i_mon[CH_MAX];
 extern int16_t debug::i_mon_dac[CH_MAX];
 #endif
 
-void Channel::adcDataIsReady(int16_t data) {
-    switch (adc.start_reg0) {
+void Channel::adcDataIsReady(uint8_t reg0, int16_t data) {
+    switch (reg0) {
     case AnalogDigitalConverter::ADC_REG0_READ_U_MON:
+        adc_read_pending &= ~ADC_READ_U_MON;
 #if CONF_DEBUG
         debug::u_mon[index - 1] = data;
 #endif
-        valueAddReading(&u, remapAdcDataToVoltage(data));
+        valueAddReading(&u, data);
         adc.start(AnalogDigitalConverter::ADC_REG0_READ_I_MON);
         break;
 
     case AnalogDigitalConverter::ADC_REG0_READ_I_MON:
+        adc_read_pending &= ~ADC_READ_I_MON;
 #if CONF_DEBUG
         debug::i_mon[index - 1] = data;
 #endif
-        valueAddReading(&i, remapAdcDataToCurrent(data));
+        valueAddReading(&i, data);
         if (isOutputEnabled()) {
+            // U_MON is read just before I_MON, so this completes one (U, I) sample
+            addHistorySample();
             adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
         }
         else {
+#if CONF_FIXED_POINT_ADC
+            u.mon_q16 = 0;
+            i.mon_q16 = 0;
+#else
             u.mon = 0;
             i.mon = 0;
+#endif
             adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_SET);
         }
         break;
 
     case AnalogDigitalConverter::ADC_REG0_READ_U_SET:
+        adc_read_pending &= ~ADC_READ_U_SET;
 #if CONF_DEBUG
         debug::u_mon_dac[index - 1] = data;
 #endif
-        valueAddReadingDac(&u, remapAdcDataToVoltage(data));
+        valueAddReadingDac(&u, data);
         adc.start(AnalogDigitalConverter::ADC_REG0_READ_I_SET);
         break;
 
     case AnalogDigitalConverter::ADC_REG0_READ_I_SET:
+        adc_read_pending &= ~ADC_READ_I_SET;
 #if CONF_DEBUG
         debug::i_mon_dac[index - 1] = data;
 #endif
-        valueAddReadingDac(&i, remapAdcDataToCurrent(data));
+        valueAddReadingDac(&i, data);
         if (isOutputEnabled()) {
             adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
         }
@@ -453,9 +735,40 @@ void Channel::setCvMode(bool cv_mode) {
 }
 
 void Channel::event(uint8_t gpio, int16_t adc_data) {
+    uint8_t head = adc_events_head;
+    if ((uint8_t)(head - adc_events_tail) == ADC_EVENT_QUEUE_SIZE) {
+        ++adc_events_dropped;
+        return;
+    }
+
+    AdcEvent &event = adc_events[head & (ADC_EVENT_QUEUE_SIZE - 1)];
+    event.time = micros();
+    event.adc_data = adc_data;
+    event.reg0 = adc.start_reg0;
+    event.gpio = gpio;
+
+    adc_events_head = head + 1;
+}
+
+void Channel::processAdcEvents() {
+    // Process only events queued so far. Processing starts the next ADC conversion,
+    // which can queue the next event before we are done here.
+    uint8_t head = adc_events_head;
+    while (adc_events_tail != head) {
+        processAdcEvent(adc_events[adc_events_tail & (ADC_EVENT_QUEUE_SIZE - 1)]);
+        adc_events_tail = adc_events_tail + 1;
+    }
+
+    if (adc_events_dropped) {
+        DebugTrace("Ch%d ADC event queue overflow, %d events dropped", index, (int)adc_events_dropped);
+        adc_events_dropped = 0;
+    }
+}
+
+void Channel::processAdcEvent(const AdcEvent &event) {
     if (!psu::isPowerUp()) return;
 
-    if (!(gpio & (1 << IOExpander::IO_BIT_IN_PWRGOOD))) {
+    if (!(event.gpio & (1 << IOExpander::IO_BIT_IN_PWRGOOD))) {
         DebugTrace("Ch%d PWRGOOD bit changed to 0", index);
         flags.power_ok = 0;
         psu::generateError(SCPI_ERROR_CHANNEL_FAULT_DETECTED);
@@ -463,28 +776,80 @@ void Channel::event(uint8_t gpio, int16_t adc_data) {
         return;
     }
 
-    adcDataIsReady(adc_data);
+    // conversion finished before the ADC readout was requested, it is already
+    // overridden by the conversion started by the request
+    if (adc_read_pending && (int32_t)(event.time - adc_read_request_start) < 0) {
+        return;
+    }
+
+    adc_event_time = event.time;
+
+    adcDataIsReady(event.reg0, event.adc_data);
 
-    setCvMode(gpio & (1 << IOExpander::IO_BIT_IN_CV_ACTIVE) ? true : false);
-    setCcMode(gpio & (1 << IOExpander::IO_BIT_IN_CC_ACTIVE) ? true : false);
+    setCvMode(event.gpio & (1 << IOExpander::IO_BIT_IN_CV_ACTIVE) ? true : false);
+    setCcMode(event.gpio & (1 << IOExpander::IO_BIT_IN_CC_ACTIVE) ? true : false);
 }
 
-void Channel::adcReadMonDac() {
+void Channel::adcRequestMonDac() {
+    // events queued so far belong to the previous conversions
+    processAdcEvents();
+
+    adc_read_request_start = micros();
+    adc_read_pending = ADC_READ_U_SET | ADC_READ_I_SET;
     adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_SET);
-    delay(ADC_TIMEOUT_MS * 2);
 }
 
-void Channel::adcReadAll() {
+void Channel::adcRequestAll() {
+    // events queued so far belong to the previous conversions
+    processAdcEvents();
+
+    adc_read_request_start = micros();
+    adc_read_pending = ADC_READ_U_MON | ADC_READ_I_MON | ADC_READ_U_SET | ADC_READ_I_SET;
     if (isOutputEnabled()) {
+        // U_SET -> I_SET -> U_MON -> I_MON -> U_MON ...
         adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_SET);
-        delay(ADC_TIMEOUT_MS * 3);
     }
     else {
+        // U_MON -> I_MON -> U_SET -> I_SET
         adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
-        delay(ADC_TIMEOUT_MS * 4);
     }
 }
 
+bool Channel::isAdcReadCompleted() {
+    return adc_read_pending == 0;
+}
+
+bool Channel::adcWaitReadCompleted() {
+    // each requested input takes at most one ADC conversion
+    while (true) {
+        processAdcEvents();
+        if (isAdcReadCompleted()) {
+            break;
+        }
+        if (micros() - adc_read_request_start > ADC_TIMEOUT_MS * 4 * 1000L) {
+            DebugTrace("Ch%d ADC readout timeout, pending=%d", index, (int)adc_read_pending);
+            return false;
+        }
+        if (adc_events_head == adc_events_tail) {
+            delayMicroseconds(100);
+        }
+    }
+#if CONF_FIXED_POINT_ADC
+    updateMonValues();
+#endif
+    return true;
+}
+
+bool Channel::adcReadMonDac() {
+    adcRequestMonDac();
+    return adcWaitReadCompleted();
+}
+
+bool Channel::adcReadAll() {
+    adcRequestAll();
+    return adcWaitReadCompleted();
+}
+
 void Channel::doDpEnable(bool enable) {
     // DP bit is active low
     ioexp.change_bit(IOExpander::IO_BIT_OUT_DP_ENABLE, !enable);
@@ -503,6 +868,9 @@ void Channel::doOutputEnable(bool enable) {
     flags.output_enabled = enable;
 
     ioexp.change_bit(IOExpander::IO_BIT_OUT_OUTPUT_ENABLE, enable);
+    if (!enable) {
+        output_disabled_time = micros();
+    }
 
     bp::switchOutput(this, enable);
 
@@ -576,11 +944,11 @@ bool Channel::isRemoteSensingEnabled() {
 void Channel::setVoltage(float value) {
     u.set = value;
     u.mon_dac = 0;
+#if CONF_FIXED_POINT_ADC
+    u.mon_dac_q16 = 0;
+#endif
 
-    if (flags.cal_enabled) {
-        value = util::remap(value, cal_conf.u.min.val, cal_conf.u.min.dac, cal_conf.u.max.val, cal_conf.u.max.dac);
-    }
-    dac.set_voltage(value);
+    dac.set_value(DigitalAnalogConverter::DATA_BUFFER_A, value * u.dac_scale + u.dac_offset);
 
     profile::save();
 }
@@ -588,15 +956,24 @@ void Channel::setVoltage(float value) {
 void Channel::setCurrent(float value) {
     i.set = value;
     i.mon_dac = 0;
+#if CONF_FIXED_POINT_ADC
+    i.mon_dac_q16 = 0;
+#endif
 
-    if (flags.cal_enabled) {
-        value = util::remap(value, cal_conf.i.min.val, cal_conf.i.min.dac, cal_conf.i.max.val, cal_conf.i.max.dac);
-    }
-    dac.set_current(value);
+    dac.set_value(DigitalAnalogConverter::DATA_BUFFER_B, value * i.dac_scale + i.dac_offset);
 
     profile::save();
 }
 
+void Channel::calibrationEnable(bool enable) {
+    flags.cal_enabled = enable;
+    onCalibrationChanged();
+}
+
+bool Channel::isCalibrationEnabled() {
+    return flags.cal_enabled;
+}
+
 bool Channel::isCalibrationExists() {
     return cal_conf.flags.i_cal_params_exists && cal_conf.flags.u_cal_params_exists;
 }
@@ -624,14 +1001,20 @@ void Channel::clearProtection() {
 
 void Channel::setQuesBits(int bit_mask, bool on) {
     reg_set_ques_isum_bit(&serial::scpi_context, this, bit_mask, on);
-    if (ethernet::test_result == psu::TEST_OK)
-        reg_set_ques_isum_bit(&ethernet::scpi_context, this, bit_mask, on);
+    if (ethernet::test_result == psu::TEST_OK) {
+        for (int i = 0; i < ethernet::NUM_SESSIONS; ++i) {
+            reg_set_ques_isum_bit(&ethernet::scpi_contexts[i], this, bit_mask, on);
+        }
+    }
 }
 
 void Channel::setOperBits(int bit_mask, bool on) {
     reg_set_oper_isum_bit(&serial::scpi_context, this, bit_mask, on);
-    if (ethernet::test_result == psu::TEST_OK)
-        reg_set_oper_isum_bit(&ethernet::scpi_context, this, bit_mask, on);
+    if (ethernet::test_result == psu::TEST_OK) {
+        for (int i = 0; i < ethernet::NUM_SESSIONS; ++i) {
+            reg_set_oper_isum_bit(&ethernet::scpi_contexts[i], this, bit_mask, on);
+        }
+    }
 }
 
 }
@@ -131,9 +131,42 @@ public:
         float mon;
         float step;
 
+        /// ADC data to calibrated value conversion:
+        /// `value = adc_data * adc_scale + adc_offset`.
+        float adc_scale;
+        float adc_offset;
+
+        /// Value to DAC data conversion (with calibration):
+        /// `dac_data = value * dac_scale + dac_offset`.
+        float dac_scale;
+        float dac_offset;
+
+        /// ADC data to calibrated value conversion in fixed point:
+        /// `value_q16 = adc_offset_q16 + (adc_data * adc_scale_q32 >> 16)`, i.e.
+        /// adc_offset_q16 is in Q16.16 and adc_scale_q32 in 2^-32 units.
+        int32_t adc_scale_q32;
+        int32_t adc_offset_q16;
+
+#if CONF_FIXED_POINT_ADC
+        /// mon and mon_dac in Q16.16 as set when ADC events are processed,
+        /// mon and mon_dac are updated from these in tick.
+        int32_t mon_q16;
+        int32_t mon_dac_q16;
+#endif
+
         void init(float def_step);
     };
 
+    /// Timestamped sample from the sample history.
+    struct Sample {
+        /// micros() when sample is taken
+        uint32_t time;
+        /// voltage in Q16.16
+        int32_t u;
+        /// current in Q16.16
+        int32_t i;
+    };
+
     /// Runtime protection binary flags (alarmed, tripped)
     struct ProtectionFlags {
         unsigned alarmed : 1;
@@ -143,7 +176,35 @@ public:
     /// Runtime protection values    
     struct ProtectionValue {
         ProtectionFlags flags;
+        /// time of the ADC conversion at which condition was first detected
         uint32_t alarm_started;
+        /// micros() when the alarm was started from the main loop
+        uint32_t alarm_processed;
+    };
+
+    enum ProtectionEventType {
+        PROTECTION_EVENT_OVP,
+        PROTECTION_EVENT_OCP,
+        PROTECTION_EVENT_OPP,
+        PROTECTION_EVENT_OTP
+    };
+
+    /// Protection event from the protection event log.
+    /// All the times are micros() values.
+    struct ProtectionEvent {
+        /// condition first detected (ADC conversion or temperature reading)
+        uint32_t onset;
+        /// alarm, i.e. delay countdown, started
+        uint32_t alarm;
+        /// protection delay expired, protection is entered
+        uint32_t trip;
+        /// output enable bit is cleared
+        uint32_t output_off;
+        /// questionable status register bit is set
+        uint32_t reg_set;
+        /// protection delay in microseconds
+        uint32_t delay;
+        uint8_t type;
     };
 
 #ifdef EEZ_PSU_SIMULATOR
@@ -352,19 +413,66 @@ public:
     void tick(unsigned long tick_usec);
 
     /// Called from IO expander interrupt routine.
+    /// Event is only queued here, it is processed later from tick.
     /// @param gpio State of IO expander GPIO register.
     /// @param adc_data ADC snapshot data.
     void event(uint8_t gpio, int16_t adc_data);
 
+    /// Process ADC events queued by the interrupt routine:
+    /// calibration, protection check, status registers and start of the next ADC conversion.
+    void processAdcEvents();
+
     /// Called when device power is turned off, so channel
     /// can do its own housekeeping.
     void onPowerDown();
 
+    /// Request fresh ADC readings of u.mon_dac and i.mon_dac.
+    /// Use isAdcReadCompleted() to find out when they are available.
+    void adcRequestMonDac();
+
+    /// Request fresh ADC readings of all values: u.mon, u.mon_dac, i.mon and i.mon_dac.
+    /// Use isAdcReadCompleted() to find out when they are available.
+    void adcRequestAll();
+
+    /// Are all the values requested with adcRequestMonDac() or adcRequestAll() refreshed?
+    bool isAdcReadCompleted();
+
+    /// Wait until all the requested values are refreshed.
+    /// @returns false if ADC didn't deliver them in time.
+    bool adcWaitReadCompleted();
+
     /// Force ADC read of u.mon_dac and i.mon_dac.
-    void adcReadMonDac();
+    /// Returns as soon as both values are refreshed.
+    /// @returns false on ADC timeout.
+    bool adcReadMonDac();
 
     /// Force ADC read of all values: u.mon, u.mon_dac, i.mon and i.mon_dac.
-    void adcReadAll();
+    /// Returns as soon as all the values are refreshed.
+    /// @returns false on ADC timeout.
+    bool adcReadAll();
+
+    /// Stop/resume adding new samples to the sample history.
+    /// History should be frozen while it is read, otherwise samples can be overwritten.
+    void freezeHistory(bool freeze);
+
+    /// Number of samples in the sample history.
+    uint16_t getHistorySize();
+
+    /// Get sample from the sample history, 0 is the oldest one.
+    const Sample &getHistorySample(uint16_t index);
+
+    /// Add event to the protection event log. Output should be already
+    /// disabled, output_off is taken from the last output disable.
+    void logProtectionEvent(uint8_t type, uint32_t onset, uint32_t alarm, uint32_t trip, uint32_t reg_set, uint32_t delay);
+
+    /// Number of events in the protection event log.
+    uint8_t getProtectionLogSize();
+
+    /// Get event from the protection event log, 0 is the oldest one.
+    const ProtectionEvent &getProtectionLogEvent(uint8_t index);
+
+    /// Clear protection event log.
+    void clearProtectionLog();
 
     /// Force update of all channel state (u.set, i.set, output enable, remote sensing, ...).
     /// This is called when channel is recovering from hardware failure.
@@ -394,6 +502,16 @@ public:
     /// Is channel calibrated, both voltage and current?
     bool isCalibrationExists();
 
+    /// Enable/disable use of calibration data (CAL:STAT).
+    void calibrationEnable(bool enable);
+
+    /// Is calibration data in use?
+    bool isCalibrationEnabled();
+
+    /// Called when calibration configuration is changed, so channel
+    /// can rebuild ADC and DAC conversion coefficients derived from it.
+    void onCalibrationChanged();
+
     /// Is OVP, OCP or OPP tripped?
     bool isTripped();
 
@@ -424,17 +542,85 @@ public:
     /// Remap current value to ADC data value (use calibration if configured).
     int16_t remapCurrentToAdcData(float value);
 
+#ifdef EEZ_PSU_SIMULATOR
+    /// Convert ADC data to calibrated voltage with two float remaps, with cached float
+    /// coefficients and with fixed point arithmetic.
+    /// Results are in nanoseconds per conversion.
+    void benchmarkAdcConversion(uint32_t iterations, float &remap_ns, float &float_ns, float &fixed_ns);
+#endif
+
 private:
     bool delayed_dp_off;
     uint32_t delayed_dp_off_start;
 
+    static const uint8_t ADC_READ_U_MON = 1 << 0;
+    static const uint8_t ADC_READ_I_MON = 1 << 1;
+    static const uint8_t ADC_READ_U_SET = 1 << 2;
+    static const uint8_t ADC_READ_I_SET = 1 << 3;
+
+    /// ADC inputs (ADC_READ_* bits) still to be read before requested readout is completed.
+    /// Bits are cleared when ADC events are processed.
+    volatile uint8_t adc_read_pending;
+    uint32_t adc_read_request_start;
+
+    /// ADC conversion result as captured by the IO expander interrupt routine.
+    struct AdcEvent {
+        uint32_t time;
+        int16_t adc_data;
+        uint8_t reg0;
+        uint8_t gpio;
+    };
+
+    /// Lock-free single producer (interrupt routine) and single consumer (main loop) queue.
+    /// Head and tail are free running counters, head is written only by the producer
+    /// and tail only by the consumer.
+    AdcEvent adc_events[ADC_EVENT_QUEUE_SIZE];
+    volatile uint8_t adc_events_head;
+    volatile uint8_t adc_events_tail;
+    volatile uint8_t adc_events_dropped;
+
+    /// Time of the ADC event currently processed.
+    uint32_t adc_event_time;
+
+    /// micros() when output enable bit was last cleared.
+    uint32_t output_disabled_time;
+
+    /// Protection event log ring buffer.
+    ProtectionEvent prot_log[PROTECTION_LOG_SIZE];
+    uint8_t prot_log_head;
+    uint8_t prot_log_size;
+
+    /// Sample history ring buffer, filled when ADC events are processed.
+    Sample history[SAMPLE_HISTORY_SIZE];
+    uint16_t history_head;
+    uint16_t history_size;
+    volatile bool history_frozen;
+
+#if CONF_FIXED_POINT_ADC
+    /// Protection thresholds in fixed point, refreshed from tick.
+    struct ProtectionThresholds {
+        int32_t u_set;
+        int32_t i_set;
+        int32_t p_level;
+        uint32_t u_delay_usec;
+        uint32_t i_delay_usec;
+        uint32_t p_delay_usec;
+    };
+    ProtectionThresholds prot_thresholds;
+
+    void updateProtectionThresholds();
+    void updateMonValues();
+#endif
+
     void clearProtectionConf();
-    void protectionEnter(ProtectionValue &cpv);
+    void protectionEnter(ProtectionValue &cpv, uint32_t delay_usec);
     void protectionCheck(ProtectionValue &cpv);
-    float readingToCalibratedValue(Value *cv, float mon_reading);
-    void valueAddReading(Value *cv, float value);
-    void valueAddReadingDac(Value *cv, float value);
-    void adcDataIsReady(int16_t data);
+    int32_t adcDataToValueQ16(const Value *cv, int16_t adc_data);
+    void valueAddReading(Value *cv, int16_t adc_data);
+    void valueAddReadingDac(Value *cv, int16_t adc_data);
+    void addHistorySample();
+    void processAdcEvent(const AdcEvent &event);
+    void adcDataIsReady(uint8_t reg0, int16_t data);
     void setCcMode(bool cc_mode);
     void setCvMode(bool cv_mode);
     void updateBoardCcAndCvSwitch();
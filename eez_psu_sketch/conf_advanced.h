@@ -36,12 +36,39 @@
 /// Profile name maximum length in number of characters
 #define PROFILE_NAME_MAX_LENGTH 32
 
+/// Time in milliseconds between the first change of the PSU setup
+/// and saving it to the profile location 0. All the changes made
+/// during that time are saved in one EEPROM write.
+#define PROFILE_SAVE_HOLD_OFF_MS 500
+
+/// CRC32 implementation used for EEPROM block checksums:
+/// CRC32_BITWISE (no table), CRC32_TABLE (1 KB table, in PROGMEM on AVR)
+/// or CRC32_SLICE_BY_8 (8 KB table in RAM, built on first use).
+/// All of them give the same checksums.
+#define CRC32_BITWISE    0
+#define CRC32_TABLE      1
+#define CRC32_SLICE_BY_8 2
+
+#ifdef EEZ_PSU_ARDUINO_MEGA
+#define CRC32_ENGINE CRC32_TABLE
+#else
+#define CRC32_ENGINE CRC32_SLICE_BY_8
+#endif
+
 /// Size in number characters of SCPI parser input buffer
 #define SCPI_PARSER_INPUT_BUFFER_LENGTH 48
 
+/// Max. number of bytes read from serial port or ethernet client and passed to SCPI parser at once
+#define SCPI_PARSER_INPUT_CHUNK_SIZE 64
+
 /// Size of SCPI parser error queue
 #define SCPI_PARSER_ERROR_QUEUE_SIZE 20
 
+/// Max. number of entries in SCPI command index, shared by all SCPI contexts.
+/// Each command needs one entry plus one for every leading optional node,
+/// e.g. [SOURce#]:VOLTage needs two. If too small, commands are searched sequentially.
+#define SCPI_PARSER_COMMAND_INDEX_SIZE 192
+
 /// Since we are not using timer, but ADC interrupt for measuring 
 /// the OVP and OCP delay there will be some error (size of which
 /// depends on ADC_SPS value). You can use the following value, which
@@ -54,6 +81,39 @@
 /// output capacitor.
 #define DP_OFF_DELAY_PERIOD 0.05
 
+/// Convert ADC data to voltage and current values and check protections in
+/// the IO expander interrupt routine using Q16.16 fixed point arithmetic
+/// instead of float. Recommended on CPU without FPU.
+#ifndef CONF_FIXED_POINT_ADC
+#ifdef EEZ_PSU_ARDUINO_MEGA
+#define CONF_FIXED_POINT_ADC 1
+#else
+#define CONF_FIXED_POINT_ADC 0
+#endif
+#endif
+
+/// Number of timestamped (U, I) samples kept per channel in the sample
+/// history, readable with FETCh:ARRay commands. Each sample takes 12 bytes of RAM.
+#ifdef EEZ_PSU_ARDUINO_MEGA
+#define SAMPLE_HISTORY_SIZE 32
+#else
+#define SAMPLE_HISTORY_SIZE 512
+#endif
+
+/// Number of ADC events (GPIO, ADC data, timestamp) the IO expander interrupt
+/// can queue per channel until they are processed in the main loop.
+/// Must be a power of two.
+#define ADC_EVENT_QUEUE_SIZE 4
+
+/// Number of protection events (OVP, OCP, OPP and OTP trips) kept per channel
+/// in the protection event log, readable with DIAGnostic:PROTection:LOG?.
+/// Each event takes 25 bytes of RAM.
+#ifdef EEZ_PSU_ARDUINO_MEGA
+#define PROTECTION_LOG_SIZE 4
+#else
+#define PROTECTION_LOG_SIZE 16
+#endif
+
 /// Text returned by the SYStem:CAPability command
 #define STR_SYST_CAP "DCSUPPLY WITH (MEASURE|MULTIPLE|TRIGGER)"
 
@@ -85,8 +85,8 @@ bool DigitalAnalogConverter::test() {
         return true;
     }
 
-    int save_cal_enabled = channel.flags.cal_enabled;
-    channel.flags.cal_enabled = 0;
+    bool save_cal_enabled = channel.isCalibrationEnabled();
+    channel.calibrationEnable(false);
 
     int save_output_enabled = channel.flags.output_enabled;
     channel.flags.output_enabled = 0;
@@ -106,7 +106,10 @@ bool DigitalAnalogConverter::test() {
 
     delay(200);
 
-    channel.adcReadMonDac();
+    if (!channel.adcReadMonDac()) {
+        test_result = psu::TEST_FAILED;
+        DebugTrace("Ch%d DAC test, ADC readout timeout", channel.index);
+    }
 
     float u_mon = channel.u.mon_dac;
     float u_diff = u_mon - u_set;
@@ -132,7 +135,7 @@ bool DigitalAnalogConverter::test() {
             (int)(i_diff * 100));
     }
 
-    channel.flags.cal_enabled = save_cal_enabled;
+    channel.calibrationEnable(save_cal_enabled);
 
     // Re-enable output just in case if it is out of sync.
     channel.flags.output_enabled = save_output_enabled;
@@ -156,15 +159,5 @@ bool DigitalAnalogConverter::test() {
     return test_result != psu::TEST_FAILED;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-
-void DigitalAnalogConverter::set_voltage(float value) {
-    set_value(DATA_BUFFER_A, util::remap(value, channel.U_MIN, (float)DAC_MIN, channel.U_MAX, (float)DAC_MAX));
-}
-
-void DigitalAnalogConverter::set_current(float value) {
-    set_value(DATA_BUFFER_B, util::remap(value, channel.I_MIN, (float)DAC_MIN, channel.I_MAX, (float)DAC_MAX));
-}
-
 }
 } // namespace eez::psu
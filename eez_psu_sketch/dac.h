@@ -37,13 +37,11 @@ public:
     bool init();
     bool test();
 
-    void set_voltage(float voltage);
-    void set_current(float voltage);
+    /// Set DAC data of the buffer, value is rounded and clamped to DAC range.
+    void set_value(uint8_t buffer, float value);
 
 private:
     Channel &channel;
-
-    void set_value(uint8_t buffer, float value);
 };
 
 }
@@ -25,6 +25,10 @@ namespace eeprom {
 
 psu::TestResult test_result = psu::TEST_FAILED;
 
+uint32_t num_bytes_written;
+uint32_t num_pages_written;
+uint32_t num_pages_skipped;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void send_address(uint16_t address) {
@@ -50,8 +54,8 @@ void read_chunk(uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
 }
 
 void read(uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
-    for (uint16_t i = 0; i < buffer_size; i += 64) {
-        read_chunk(buffer + i, min(buffer_size - i, 64), address + i);
+    for (uint16_t i = 0; i < buffer_size; i += EEPROM_PAGE_SIZE) {
+        read_chunk(buffer + i, min(buffer_size - i, EEPROM_PAGE_SIZE), address + i);
     }
 }
 
@@ -63,7 +67,9 @@ bool is_write_in_progress() {
     return (data & (1 << 0));
 }
 
-void write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
+/// Write at most EEPROM_PAGE_SIZE bytes and read them back.
+/// \returns true if verification succeeded.
+bool write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
     SPI.beginTransaction(AT25256B_SPI);
 
     // enable writing
@@ -98,19 +104,31 @@ void write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address)
     digitalWrite(EEPROM_SELECT, HIGH); // deselect chip
 
     SPI.endTransaction();
+
+    num_bytes_written += buffer_size;
+    ++num_pages_written;
+
+    // verify
+    uint8_t buffer_verify[EEPROM_PAGE_SIZE];
+    read_chunk(buffer_verify, buffer_size, address);
+    return memcmp(buffer, buffer_verify, buffer_size) == 0;
 }
 
-bool write(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
-    for (uint16_t i = 0; i < buffer_size; i += 64) {
-        write_chunk(buffer + i, min(buffer_size - i, 64), address + i);
-    }
+bool write(const uint8_t *buffer, uint16_t buffer_size, uint16_t address, const uint8_t *previous) {
+    bool result = true;
 
-    uint8_t *buffer_verify = (uint8_t *)malloc(buffer_size);
-    read(buffer_verify, buffer_size, address);
+    for (uint16_t i = 0; i < buffer_size; i += EEPROM_PAGE_SIZE) {
+        uint16_t chunk_size = min(buffer_size - i, EEPROM_PAGE_SIZE);
 
-    bool result = memcmp(buffer, buffer_verify, buffer_size) == 0;
+        if (previous && memcmp(buffer + i, previous + i, chunk_size) == 0) {
+            ++num_pages_skipped;
+            continue;
+        }
 
-    free(buffer_verify);
+        if (!write_chunk(buffer + i, chunk_size, address + i)) {
+            result = false;
+        }
+    }
 
     return result;
 }
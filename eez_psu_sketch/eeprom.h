@@ -202,13 +202,28 @@ static const uint8_t WRITE = 2;
 
 static const uint16_t EEPROM_START_ADDRESS = 1024;
 
+/// AT25256B page size, max. number of bytes in one write cycle.
+static const uint16_t EEPROM_PAGE_SIZE = 64;
+
 bool init();
 bool test();
 
 extern TestResult test_result;
 
+/// Number of bytes written to the EEPROM since power up.
+extern uint32_t num_bytes_written;
+/// Number of pages written to the EEPROM since power up.
+extern uint32_t num_pages_written;
+/// Number of pages not written because they were not changed.
+extern uint32_t num_pages_skipped;
+
 void read(uint8_t *buffer, uint16_t buffer_size, uint16_t address);
-bool write(const uint8_t *buffer, uint16_t buffer_size, uint16_t address);
+
+/// Write buffer to the EEPROM at given address.
+/// If previous is given, it must hold the current EEPROM content at the address
+/// and only the pages which differ from it are written.
+/// \returns true if written pages are verified.
+bool write(const uint8_t *buffer, uint16_t buffer_size, uint16_t address, const uint8_t *previous = 0);
 
 }
 }
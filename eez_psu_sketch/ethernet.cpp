@@ -37,8 +37,14 @@ uint8_t mac[6] = { 0x74,0x69,0x69,0x2D,0x30,0x00 };
 
 EthernetServer server(TCP_PORT);
 
-bool firstClientDetected = false;
-EthernetClient firstClient;
+const int NUM_SESSIONS = UIP_CONF_MAX_CONNECTIONS;
+
+/// Client of each session, session is active while client is connected.
+EthernetClient clients[UIP_CONF_MAX_CONNECTIONS];
+bool session_active[UIP_CONF_MAX_CONNECTIONS];
+
+/// Session serviced first in the next tick.
+static int next_session = 0;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -57,7 +63,11 @@ size_t ethernet_client_write_str(EthernetClient &client, const char *str) {
 ////////////////////////////////////////////////////////////////////////////////
 
 size_t SCPI_Write(scpi_t *context, const char * data, size_t len) {
-    return ethernet_client_write(firstClient, data, len);
+    int session = context - scpi_contexts;
+    if (!session_active[session]) {
+        return 0;
+    }
+    return ethernet_client_write(clients[session], data, len);
 }
 
 scpi_result_t SCPI_Flush(scpi_t * context) {
@@ -92,10 +102,16 @@ scpi_result_t SCPI_Reset(scpi_t *context) {
     return psu::reset() ? SCPI_RES_OK : SCPI_RES_ERR;
 }
 
+scpi_bool_t SCPI_Hold(scpi_t *context) {
+    // program message units received after the one which started power up
+    // are kept in the input buffer until power up is finished
+    return psu::isPowerUpInProgress();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
-scpi_reg_val_t scpi_psu_regs[SCPI_PSU_REG_COUNT];
-scpi_psu_t scpi_psu_context = { scpi_psu_regs, 1 };
+scpi_reg_val_t scpi_psu_regs[UIP_CONF_MAX_CONNECTIONS][SCPI_PSU_REG_COUNT];
+scpi_psu_t scpi_psu_contexts[UIP_CONF_MAX_CONNECTIONS];
 
 scpi_interface_t scpi_interface = {
     SCPI_Error,
@@ -103,15 +119,32 @@ scpi_interface_t scpi_interface = {
     SCPI_Control,
     SCPI_Flush,
     SCPI_Reset,
+    SCPI_Hold,
 };
 
-char scpi_input_buffer[SCPI_PARSER_INPUT_BUFFER_LENGTH];
-int16_t error_queue_data[SCPI_PARSER_ERROR_QUEUE_SIZE + 1];
+char scpi_input_buffers[UIP_CONF_MAX_CONNECTIONS][SCPI_PARSER_INPUT_BUFFER_LENGTH];
+int16_t error_queue_data[UIP_CONF_MAX_CONNECTIONS][SCPI_PARSER_ERROR_QUEUE_SIZE + 1];
 
-scpi_t scpi_context;
+scpi_t scpi_contexts[UIP_CONF_MAX_CONNECTIONS];
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Put SCPI context of the session to the initial state, so that a new client
+/// doesn't get the input, error queue, status registers and FORMat settings
+/// left by the previous client of the same session.
+static void initSession(int i) {
+    memset(scpi_psu_regs[i], 0, sizeof(scpi_psu_regs[i]));
+    memset(&scpi_psu_contexts[i], 0, sizeof(scpi_psu_contexts[i]));
+    scpi_psu_contexts[i].registers = scpi_psu_regs[i];
+    scpi_psu_contexts[i].selected_channel_index = 1;
+
+    scpi::init(scpi_contexts[i],
+        scpi_psu_contexts[i],
+        &scpi_interface,
+        scpi_input_buffers[i], SCPI_PARSER_INPUT_BUFFER_LENGTH,
+        error_queue_data[i], SCPI_PARSER_ERROR_QUEUE_SIZE + 1);
+}
+
 bool init() {
     if (OPTION_ETHERNET) {
 #ifdef EEZ_PSU_ARDUINO
@@ -138,14 +171,12 @@ bool init() {
         Serial.print("DNS IP: "); Serial.println(Ethernet.dnsServerIP());
 #endif
 #else
-        Serial.print("Listening on port "); Serial.println(TCP_PORT);
+        Serial.print("Listening on port "); Serial.println(simulator::getTcpPort());
 #endif
 
-        scpi::init(scpi_context,
-            scpi_psu_context,
-            &scpi_interface,
-            scpi_input_buffer, SCPI_PARSER_INPUT_BUFFER_LENGTH,
-            error_queue_data, SCPI_PARSER_ERROR_QUEUE_SIZE + 1);
+        for (int i = 0; i < NUM_SESSIONS; ++i) {
+            initSession(i);
+        }
     }
     else {
         DebugTrace("Ethernet initialization skipped!");
@@ -163,6 +194,24 @@ bool test() {
     return test_result != psu::TEST_FAILED;
 }
 
+static int findSession(EthernetClient &client) {
+    for (int i = 0; i < NUM_SESSIONS; ++i) {
+        if (session_active[i] && clients[i] == client) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int findFreeSession() {
+    for (int i = 0; i < NUM_SESSIONS; ++i) {
+        if (!session_active[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 void tick(unsigned long tick_usec) {
     if (test_result != psu::TEST_OK) {
         return;
@@ -170,47 +219,68 @@ void tick(unsigned long tick_usec) {
 
     SPI.beginTransaction(ENC28J60_SPI);
 
-    if (firstClientDetected) {
-        if (!firstClient.connected()) {
-            firstClientDetected = false;
-            firstClient = EthernetClient();
-            DebugTrace("Ethernet client lost!");
+    for (int i = 0; i < NUM_SESSIONS; ++i) {
+        if (session_active[i] && !clients[i].connected()) {
+            session_active[i] = false;
+            clients[i] = EthernetClient();
+            DebugTrace("Ethernet client %d lost!", i + 1);
         }
     }
 
+    // server returns client with received data, it is a new client if not found in sessions
     EthernetClient client = server.available();
+    if (client && findSession(client) == -1) {
+        int i = findFreeSession();
+        if (i != -1) {
+            initSession(i);
+            clients[i] = client;
+            session_active[i] = true;
+            DebugTrace("A new ethernet client %d detected!", i + 1);
+        }
+        else {
+            SPI.endTransaction();
+            ethernet_client_write_str(client, "Too many clients!\r\n");
+            SPI.beginTransaction(ENC28J60_SPI);
+
+            client.stop();
 
-    if (client) {
-        if (!firstClient) {
-            firstClient = client;
-            firstClientDetected = true;
-            DebugTrace("A new ethernet client detected!");
+            DebugTrace("Another client detected and disconnected!");
         }
+    }
 
-        size_t size;
-        while ((size = client.available()) > 0) {
-            uint8_t* msg = (uint8_t*)malloc(size);
-            size = client.read(msg, size);
-            if (client == firstClient) {
-                SPI.endTransaction();
-                for (size_t i = 0; i < size; ++i) {
-                    input(scpi_context, msg[i]);
-                }
-                SPI.beginTransaction(ENC28J60_SPI);
-            }
-            else {
-                SPI.endTransaction();
-                ethernet_client_write_str(client, "Already connected!\r\n");
-                SPI.beginTransaction(ENC28J60_SPI);
+    // Service sessions round-robin, at most one chunk of received data per
+    // session in each tick, so that a busy client can't starve the others
+    // nor the rest of the main loop.
+    char buffer[SCPI_PARSER_INPUT_CHUNK_SIZE];
+    for (int j = 0; j < NUM_SESSIONS; ++j) {
+        // input is queued in client buffers until power up is finished
+        if (psu::isPowerUpInProgress()) {
+            break;
+        }
+
+        int i = (next_session + j) % NUM_SESSIONS;
+        if (!session_active[i]) {
+            continue;
+        }
 
-                client.stop();
+        if (scpi_contexts[i].buffer.held) {
+            SPI.endTransaction();
+            resumeInput(scpi_contexts[i]);
+            SPI.beginTransaction(ENC28J60_SPI);
+        }
 
-                DebugTrace("Another client detected and disconnected!");
+        if (!psu::isPowerUpInProgress() && clients[i].available() > 0) {
+            size_t size = clients[i].read((uint8_t *)buffer, SCPI_PARSER_INPUT_CHUNK_SIZE);
+            if (size > 0) {
+                SPI.endTransaction();
+                input(scpi_contexts[i], buffer, size);
+                SPI.beginTransaction(ENC28J60_SPI);
             }
-            free(msg);
         }
     }
 
+    next_session = (next_session + 1) % NUM_SESSIONS;
+
     SPI.endTransaction();
 }
 
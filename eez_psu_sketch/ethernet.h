@@ -25,7 +25,11 @@ namespace psu {
 namespace ethernet {
 
 extern TestResult test_result;
-extern scpi_t scpi_context;
+
+/// Number of SCPI sessions, one for each simultaneously connected client.
+extern const int NUM_SESSIONS;
+/// SCPI parser context of each session.
+extern scpi_t scpi_contexts[];
 
 bool init();
 bool test();
@@ -143,6 +143,7 @@ void IOExpander::on_interrupt() {
     int16_t adc_data = channel.adc.read();
     uint8_t gpio = reg_read(REG_GPIO);
 
+    // only queue the event, it is processed from the main loop
     channel.event(gpio, adc_data);
 
 #if CONF_DEBUG
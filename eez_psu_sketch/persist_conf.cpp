@@ -52,6 +52,11 @@ static const uint16_t PERSIST_CONF_PROFILE_BLOCK_SIZE = 1024;
 
 DeviceConfiguration dev_conf;
 
+/// Copy of the profile location 0 as it is stored in the EEPROM.
+/// It is used to write only the changed pages when the location 0 is saved.
+static profile::Parameters profile0_shadow;
+static bool profile0_shadow_valid = false;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 uint32_t calc_checksum(const BlockHeader *block, uint16_t size) {
@@ -62,11 +67,11 @@ bool check_block(const BlockHeader *block, uint16_t size, uint16_t version) {
     return block->checksum == calc_checksum(block, size) && block->version == version;
 }
 
-bool save(BlockHeader *block, uint16_t size, uint16_t address, uint16_t version) {
+bool save(BlockHeader *block, uint16_t size, uint16_t address, uint16_t version, const BlockHeader *previous = 0) {
     if (eeprom::test_result == psu::TEST_OK) {
         block->version = version;
         block->checksum = calc_checksum(block, size);
-        return eeprom::write((const uint8_t *)block, size, address);
+        return eeprom::write((const uint8_t *)block, size, address, (const uint8_t *)previous);
     }
     return true;
 }
@@ -209,12 +214,29 @@ bool saveChannelCalibration(Channel *channel) {
 bool loadProfile(int location, profile::Parameters *profile) {
     if (eeprom::test_result == psu::TEST_OK) {
         eeprom::read((uint8_t *)profile, sizeof(profile::Parameters), get_profile_address(location));
+        if (location == 0) {
+            memcpy(&profile0_shadow, profile, sizeof(profile::Parameters));
+            profile0_shadow_valid = true;
+        }
         return check_block((BlockHeader *)profile, sizeof(profile::Parameters), PROFILE_VERSION);
     }
     return false;
 }
 
 bool saveProfile(int location, profile::Parameters *profile) {
+    if (location == 0) {
+        bool result = save((BlockHeader *)profile, sizeof(profile::Parameters), get_profile_address(location), PROFILE_VERSION,
+            profile0_shadow_valid ? (BlockHeader *)&profile0_shadow : 0);
+
+        if (eeprom::test_result == psu::TEST_OK) {
+            // if verification failed we don't know what is in the EEPROM, so next time write everything
+            memcpy(&profile0_shadow, profile, sizeof(profile::Parameters));
+            profile0_shadow_valid = result;
+        }
+
+        return result;
+    }
+
     return save((BlockHeader *)profile, sizeof(profile::Parameters), get_profile_address(location), PROFILE_VERSION);
 }
 
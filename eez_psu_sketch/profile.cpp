@@ -20,6 +20,7 @@
 #include "profile.h"
 #include "persist_conf.h"
 #include "datetime.h"
+#include "eeprom.h"
 
 namespace eez {
 namespace psu {
@@ -27,11 +28,79 @@ namespace profile {
 
 static bool g_save_enabled = true;
 static bool g_save_profile = false;
+static unsigned long g_save_profile_request_usec;
+
+static DirectoryEntry g_directory[NUM_PROFILE_LOCATIONS];
+
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t getTimestamp() {
+    uint8_t year, month, day, hour, minute, second;
+    if (datetime::getDate(year, month, day) && datetime::getTime(hour, minute, second)) {
+        return ((uint32_t)year << 26) | ((uint32_t)month << 22) | ((uint32_t)day << 17) |
+            ((uint32_t)hour << 12) | ((uint32_t)minute << 6) | second;
+    }
+    return 0;
+}
+
+static void setDirectoryEntry(int location, const Parameters *profile, uint32_t timestamp) {
+    DirectoryEntry &entry = g_directory[location];
+    entry.checksum = profile->header.checksum;
+    entry.timestamp = timestamp;
+    entry.is_valid = profile->is_valid;
+    memset(entry.name, 0, sizeof(entry.name));
+    if (entry.is_valid) {
+        strncpy(entry.name, profile->name, PROFILE_NAME_MAX_LENGTH);
+    }
+}
+
+static void loadDirectoryEntry(int location) {
+    Parameters profile;
+    if (!persist_conf::loadProfile(location, &profile)) {
+        profile.header.checksum = 0;
+        profile.is_valid = false;
+    }
+    setDirectoryEntry(location, &profile, 0);
+}
+
+/// Save profile and keep the directory in sync with the EEPROM.
+static bool saveProfile(int location, Parameters *profile) {
+    if (eeprom::test_result != psu::TEST_OK) {
+        return persist_conf::saveProfile(location, profile);
+    }
+
+    if (persist_conf::saveProfile(location, profile)) {
+        setDirectoryEntry(location, profile, getTimestamp());
+        return true;
+    }
+
+    // write failed, find out what is in the EEPROM now
+    loadDirectoryEntry(location);
+    return false;
+}
+
+void loadDirectory() {
+    for (int i = 0; i < NUM_PROFILE_LOCATIONS; ++i) {
+        loadDirectoryEntry(i);
+    }
+}
+
+const DirectoryEntry *getDirectoryEntry(int location) {
+    if (location >= 0 && location < NUM_PROFILE_LOCATIONS) {
+        return &g_directory[location];
+    }
+    return 0;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void tick(unsigned long tick_usec) {
-    if (g_save_profile) {
+    // don't save the state in the middle of power up sequence
+    if (psu::isPowerUpInProgress()) {
+        return;
+    }
+
+    if (g_save_profile && tick_usec - g_save_profile_request_usec >= PROFILE_SAVE_HOLD_OFF_MS * 1000UL) {
         saveAtLocation(0);
         g_save_profile = false;
     }
@@ -61,7 +130,7 @@ void recallChannelsFromProfile(Parameters *profile) {
         Channel::get(i).simulator.load = profile->channels[i].load;
 #endif
 
-        Channel::get(i).flags.cal_enabled = profile->channels[i].flags.cal_enabled && Channel::get(i).isCalibrationExists() ? 1 : 0;
+        Channel::get(i).calibrationEnable(profile->channels[i].flags.cal_enabled && Channel::get(i).isCalibrationExists());
         Channel::get(i).flags.output_enabled = profile->channels[i].flags.output_enabled;
         Channel::get(i).flags.sense_enabled = profile->channels[i].flags.sense_enabled;
 
@@ -71,15 +140,26 @@ void recallChannelsFromProfile(Parameters *profile) {
     enableSave(last_save_enabled);
 }
 
-bool recallFromProfile(Parameters *profile) {
+bool recallFromProfile(Parameters *profile, int location) {
     bool last_save_enabled = enableSave(false);
 
     bool result = true;
 
     memcpy(temperature::prot_conf, profile->temp_prot, sizeof(profile->temp_prot));
 
-    if (profile->power_is_up) result &= psu::powerUp();
-    else psu::powerDown();
+    if (profile->power_is_up) {
+        if (location != -1 && (!psu::isPowerUp() || psu::isPowerUpInProgress())) {
+            // channels are recalled from the location when power up is finished
+            result &= psu::startPowerUp(location);
+            enableSave(last_save_enabled);
+            return result;
+        }
+
+        result &= psu::powerUp();
+    }
+    else {
+        psu::powerDown();
+    }
 
     recallChannelsFromProfile(profile);
 
@@ -92,8 +172,8 @@ bool recall(int location) {
     if (location > 0 && location < NUM_PROFILE_LOCATIONS) {
         Parameters profile;
         if (persist_conf::loadProfile(location, &profile) && profile.is_valid) {
-            if (persist_conf::saveProfile(0, &profile)) {
-                return recallFromProfile(&profile);
+            if (saveProfile(0, &profile)) {
+                return recallFromProfile(&profile, location);
             }
         }
     }
@@ -115,18 +195,22 @@ bool enableSave(bool enable) {
 
 void save() {
     if (!g_save_enabled) return;
-    g_save_profile = true;
+    if (!g_save_profile) {
+        // changes are coalesced until PROFILE_SAVE_HOLD_OFF_MS elapses
+        g_save_profile_request_usec = micros();
+        g_save_profile = true;
+    }
 }
 
 bool saveAtLocation(int location) {
     if (location >= 0 && location < NUM_PROFILE_LOCATIONS) {
-        Parameters currentProfile;
-        if (!persist_conf::loadProfile(location, &currentProfile)) {
-            currentProfile.is_valid = false;
-        }
+        const DirectoryEntry &currentProfile = g_directory[location];
 
         Parameters profile;
 
+        // clear padding bytes, so unchanged profile is always written the same way
+        memset(&profile, 0, sizeof(profile));
+
         profile.is_valid = true;
 
         // name
@@ -178,7 +262,7 @@ bool saveAtLocation(int location) {
 
         interrupts();
 
-        return persist_conf::saveProfile(location, &profile);
+        return saveProfile(location, &profile);
     }
 
     return false;
@@ -188,11 +272,12 @@ bool deleteLocation(int location) {
     bool result = false;
     if (location > 0 && location < NUM_PROFILE_LOCATIONS) {
         Parameters profile;
+        memset(&profile, 0, sizeof(profile));
         profile.is_valid = false;
         if (location == persist_conf::getProfileAutoRecallLocation()) {
             persist_conf::setProfileAutoRecallLocation(0);
         }
-        result = persist_conf::saveProfile(location, &profile);
+        result = saveProfile(location, &profile);
     }
     return result;
 }
@@ -208,10 +293,7 @@ bool deleteAll() {
 
 bool isValid(int location) {
     if (location >= 0 && location < NUM_PROFILE_LOCATIONS) {
-        Parameters profile;
-        if (persist_conf::loadProfile(location, &profile)) {
-            return profile.is_valid;
-        }
+        return g_directory[location].is_valid;
     }
     return false;
 }
@@ -222,19 +304,16 @@ bool setName(int location, const char *name, size_t name_len) {
         if (persist_conf::loadProfile(location, &profile) && profile.is_valid) {
             memset(profile.name, 0, sizeof(profile.name));
             strncpy(profile.name, name, name_len);
-            return persist_conf::saveProfile(location, &profile);
+            return saveProfile(location, &profile);
         }
     }
     return false;
 }
 
 void getName(int location, char *name) {
-    if (location >= 0 && location < NUM_PROFILE_LOCATIONS) {
-        Parameters profile;
-        if (persist_conf::loadProfile(location, &profile) && profile.is_valid) {
-            strcpy(name, profile.name);
-            return;
-        }
+    if (location >= 0 && location < NUM_PROFILE_LOCATIONS && g_directory[location].is_valid) {
+        strcpy(name, g_directory[location].name);
+        return;
     }
     strcpy(name, "--Not used--");
 }
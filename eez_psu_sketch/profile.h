@@ -70,10 +70,29 @@ struct Parameters {
     temperature::ProtectionConfiguration temp_prot[temp_sensor::COUNT];
 };
 
+/// Profile directory entry, kept in RAM so profile names and
+/// validity can be queried without reading the EEPROM.
+struct DirectoryEntry {
+    /// Block checksum as stored in the EEPROM.
+    uint32_t checksum;
+    /// Date and time of the last save packed as YYYYYYMMMMDDDDDHHHHHMMMMMMSSSSSS bits,
+    /// 0 if not saved since power up or date and time is not set.
+    uint32_t timestamp;
+    bool is_valid;
+    char name[PROFILE_NAME_MAX_LENGTH + 1];
+};
+
+/// Read all the profile locations from the EEPROM and build profile directory.
+void loadDirectory();
+const DirectoryEntry *getDirectoryEntry(int location);
+
 void tick(unsigned long tick_usec);
 
 void recallChannelsFromProfile(Parameters *profile);
-bool recallFromProfile(Parameters *profile);
+/// Recall PSU state from profile.
+/// \param location If given and power up is required, it is done asynchronously
+///        and channels are recalled from this location when it is finished.
+bool recallFromProfile(Parameters *profile, int location = -1);
 bool recall(int location);
 
 bool load(int location, Parameters *profile);
@@ -46,6 +46,20 @@ static bool g_power_is_up = false;
 static bool g_test_power_up_delay = false;
 static unsigned long g_power_down_time;
 
+enum PowerUpState {
+    POWER_UP_IDLE,
+    POWER_UP_SOFT_START,
+    POWER_UP_DIRECT,
+    POWER_UP_INIT_CHANNELS
+};
+
+static PowerUpState g_power_up_state = POWER_UP_IDLE;
+static unsigned long g_power_up_state_time;
+static int g_power_up_channel_index;
+static bool g_power_up_success;
+static int g_power_up_recall_location;
+static bool g_power_up_update_channels;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 static bool psu_reset(bool power_on);
@@ -72,6 +86,8 @@ void boot() {
         persist_conf::loadChannelCalibration(&Channel::get(i));
     }
 
+    profile::loadDirectory();
+
     // auto recall profile or ...
     profile::Parameters profile;
     if (persist_conf::isProfileAutoRecallEnabled() && profile::load(persist_conf::getProfileAutoRecallLocation(), &profile)) {
@@ -158,41 +174,144 @@ void boot() {
     */
 }
 
-bool powerUp() {
-    if (g_power_is_up) return true;
-    if (temperature::isSensorTripped(temp_sensor::MAIN)) return false;
-
-    // reset channels
-    for (int i = 0; i < CH_NUM; ++i) {
-        Channel::get(i).reset();
+static void afterPowerUp() {
+    if (g_power_up_recall_location != -1) {
+        profile::Parameters profile;
+        if (profile::load(g_power_up_recall_location, &profile)) {
+            profile::recallChannelsFromProfile(&profile);
+        }
     }
 
-    // turn power on
-    board::powerUp();
-    g_power_is_up = true;
-
-    // turn off standby blue LED
-    bp::switchStandby(false);
-
-    bool success = true;
-
-    // init channels
-    for (int i = 0; i < CH_NUM; ++i) {
-        success &= Channel::get(i).init();
+    if (g_power_up_update_channels) {
+        for (int i = 0; i < CH_NUM; ++i) {
+            Channel::get(i).update();
+        }
     }
+}
+
+static void finishPowerUp() {
+    g_power_up_state = POWER_UP_IDLE;
 
     // turn on Power On (PON) bit of ESE register
     setEsrBits(ESR_PON);
 
     // play power up tune on success
-    if (success) {
+    if (g_power_up_success) {
         sound::playPowerUp();
     }
 
-    return success;
+    afterPowerUp();
+
+    setOperBits(OPER_PWRUP, false);
+}
+
+/// Advance power up sequence, each step is done in separate tick.
+static void powerUpTick() {
+    switch (g_power_up_state) {
+    case POWER_UP_SOFT_START:
+        if (millis() - g_power_up_state_time >= board::POWER_UP_SOFT_START_MS) {
+            board::powerUpDirect();
+            g_power_up_state = POWER_UP_DIRECT;
+            g_power_up_state_time = millis();
+        }
+        break;
+
+    case POWER_UP_DIRECT:
+        if (millis() - g_power_up_state_time >= board::POWER_UP_DIRECT_MS) {
+            board::powerUpFinish();
+            g_power_is_up = true;
+
+            // turn off standby blue LED
+            bp::switchStandby(false);
+
+            g_power_up_state = POWER_UP_INIT_CHANNELS;
+            g_power_up_channel_index = 0;
+        }
+        break;
+
+    case POWER_UP_INIT_CHANNELS:
+        // init one channel per tick
+        g_power_up_success &= Channel::get(g_power_up_channel_index++).init();
+        if (g_power_up_channel_index == CH_NUM) {
+            finishPowerUp();
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+bool startPowerUp(int recall_location, bool update_channels) {
+    if (g_power_is_up && g_power_up_state == POWER_UP_IDLE) {
+        g_power_up_recall_location = recall_location;
+        g_power_up_update_channels = update_channels;
+        afterPowerUp();
+        return true;
+    }
+
+    if (g_power_up_state == POWER_UP_IDLE) {
+        if (temperature::isSensorTripped(temp_sensor::MAIN)) return false;
+
+        // reset channels
+        for (int i = 0; i < CH_NUM; ++i) {
+            Channel::get(i).reset();
+        }
+
+        // turn power on
+        board::powerUpSoftStart();
+        g_power_up_state = POWER_UP_SOFT_START;
+        g_power_up_state_time = millis();
+        g_power_up_success = true;
+
+        setOperBits(OPER_PWRUP, true);
+    }
+
+    // if already in progress, the latest request decides what happens at the end
+    g_power_up_recall_location = recall_location;
+    g_power_up_update_channels = update_channels;
+
+    return true;
+}
+
+bool isPowerUpInProgress() {
+    return g_power_up_state != POWER_UP_IDLE;
+}
+
+/// Block until power up sequence, if any, is finished.
+/// \returns true if power is up.
+static bool waitPowerUp() {
+    while (g_power_up_state != POWER_UP_IDLE) {
+        powerUpTick();
+        if (g_power_up_state == POWER_UP_SOFT_START || g_power_up_state == POWER_UP_DIRECT) {
+            delay(1);
+        }
+    }
+    return g_power_is_up;
+}
+
+bool powerUp() {
+    if (g_power_is_up && g_power_up_state == POWER_UP_IDLE) return true;
+
+    if (!startPowerUp()) {
+        return false;
+    }
+
+    return waitPowerUp() && g_power_up_success;
 }
 
 void powerDown() {
+    if (g_power_up_state != POWER_UP_IDLE) {
+        // abort power up sequence
+        g_power_up_state = POWER_UP_IDLE;
+        setOperBits(OPER_PWRUP, false);
+
+        if (!g_power_is_up) {
+            board::powerDown();
+            return;
+        }
+    }
+
     if (!g_power_is_up) return;
 
     for (int i = 0; i < CH_NUM; ++i) {
@@ -214,7 +333,7 @@ bool isPowerUp() {
 }
 
 bool changePowerState(bool up) {
-    if (up == g_power_is_up) return true;
+    if (up == g_power_is_up && g_power_up_state == POWER_UP_IDLE) return true;
 
     if (up) {
         // at least MIN_POWER_UP_DELAY seconds shall pass after last power down
@@ -223,15 +342,11 @@ bool changePowerState(bool up) {
             g_test_power_up_delay = false;
         }
 
-        if (!powerUp()) {
+        // auto recall channels parameters from profile when power up is finished
+        int recall_location = persist_conf::isProfileAutoRecallEnabled() ? persist_conf::getProfileAutoRecallLocation() : -1;
+        if (!startPowerUp(recall_location)) {
             return false;
         }
-
-        // auto recall channels parameters from profile
-        profile::Parameters profile;
-        if (persist_conf::isProfileAutoRecallEnabled() && profile::load(persist_conf::getProfileAutoRecallLocation(), &profile)) {
-            profile::recallChannelsFromProfile(&profile);
-        }
     }
     else {
         powerDown();
@@ -291,8 +406,11 @@ static bool psu_reset(bool power_on) {
 
     // SYST:ERR:COUN? 0
     SCPI_ErrorClear(&serial::scpi_context);
-    if (ethernet::test_result == TEST_OK)
-        SCPI_ErrorClear(&ethernet::scpi_context);
+    if (ethernet::test_result == TEST_OK) {
+        for (int i = 0; i < ethernet::NUM_SESSIONS; ++i) {
+            SCPI_ErrorClear(&ethernet::scpi_contexts[i]);
+        }
+    }
 
     // TEMP:PROT[MAIN]
     // TEMP:PROT:DEL
@@ -320,6 +438,11 @@ static bool psu_reset(bool power_on) {
     calibration::stop();
 
     // SYST:POW ON
+    if (!power_on) {
+        // channels are updated when power up is finished
+        return startPowerUp(-1, true);
+    }
+
     if (powerUp()) {
         for (int i = 0; i < CH_NUM; ++i) {
             Channel::get(i).update();
@@ -379,6 +502,10 @@ bool test() {
 void tick() {
     unsigned long tick_usec = micros();
 
+    if (g_power_up_state != POWER_UP_IDLE) {
+        powerUpTick();
+    }
+
 #if CONF_DEBUG
     debug::tick(tick_usec);
 #endif
@@ -397,21 +524,37 @@ void tick() {
 
 void setEsrBits(int bit_mask) {
     SCPI_RegSetBits(&serial::scpi_context, SCPI_REG_ESR, bit_mask);
-    if (ethernet::test_result == TEST_OK)
-        SCPI_RegSetBits(&ethernet::scpi_context, SCPI_REG_ESR, bit_mask);
+    if (ethernet::test_result == TEST_OK) {
+        for (int i = 0; i < ethernet::NUM_SESSIONS; ++i) {
+            SCPI_RegSetBits(&ethernet::scpi_contexts[i], SCPI_REG_ESR, bit_mask);
+        }
+    }
 }
 
+void setOperBits(int bit_mask, bool on) {
+    reg_set_oper_bit(&serial::scpi_context, bit_mask, on);
+    if (ethernet::test_result == TEST_OK) {
+        for (int i = 0; i < ethernet::NUM_SESSIONS; ++i) {
+            reg_set_oper_bit(&ethernet::scpi_contexts[i], bit_mask, on);
+        }
+    }
+}
 
 void setQuesBits(int bit_mask, bool on) {
     reg_set_ques_bit(&serial::scpi_context, bit_mask, on);
-    if (ethernet::test_result == TEST_OK)
-        reg_set_ques_bit(&ethernet::scpi_context, bit_mask, on);
+    if (ethernet::test_result == TEST_OK) {
+        for (int i = 0; i < ethernet::NUM_SESSIONS; ++i) {
+            reg_set_ques_bit(&ethernet::scpi_contexts[i], bit_mask, on);
+        }
+    }
 }
 
 void generateError(int16_t error) {
     SCPI_ErrorPush(&serial::scpi_context, error);
     if (ethernet::test_result == TEST_OK) {
-        SCPI_ErrorPush(&ethernet::scpi_context, error);
+        for (int i = 0; i < ethernet::NUM_SESSIONS; ++i) {
+            SCPI_ErrorPush(&ethernet::scpi_contexts[i], error);
+        }
     }
 }
 
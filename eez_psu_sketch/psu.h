@@ -73,8 +73,20 @@ bool test();
 
 void tick();
 
+/// Start power up sequence, it is finished later from the tick().
+/// \param recall_location Channels are recalled from this profile location
+///        when power up is finished, -1 if nothing should be recalled.
+/// \param update_channels Update channels when power up is finished.
+/// \returns false if power up is not allowed.
+bool startPowerUp(int recall_location = -1, bool update_channels = false);
+
+/// Is power up sequence in progress? SCPI input is not processed until it is finished,
+/// the OPER_PWRUP transitions are still latched in the OPERation event register.
+bool isPowerUpInProgress();
+
 void setEsrBits(int bit_mask);
 void setQuesBits(int bit_mask, bool on);
+void setOperBits(int bit_mask, bool on);
 
 void generateError(int16_t error);
 
@@ -49,6 +49,15 @@ scpi_result_t scpi_core_IdnQ(scpi_t * context) {
     return SCPI_CoreIdnQ(context);
 }
 
+/**
+* Implement IEEE488.2 *OPC
+*
+* Input is held while power up is in progress (see SCPI_Hold), so *OPC, *OPC?
+* and *WAI are executed only after power up started by a previous command
+* is finished and there is nothing left to wait for.
+*
+* Return SCPI_RES_OK
+*/
 scpi_result_t scpi_core_Opc(scpi_t * context) {
     return SCPI_CoreOpc(context);
 }
@@ -79,6 +88,7 @@ scpi_result_t scpi_core_Rcl(scpi_t * context) {
 }
 
 scpi_result_t scpi_core_Rst(scpi_t * context) {
+    resetDataFormat(*context);
     return SCPI_CoreRst(context);
 }
 
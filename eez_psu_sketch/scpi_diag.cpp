@@ -72,7 +72,10 @@ scpi_result_t scpi_diag_InformationADCQ(scpi_t * context) {
         return SCPI_RES_ERR;
     }
 
-    channel->adcReadAll();
+    if (!channel->adcReadAll()) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
 
     char buffer[64] = { 0 };
 
@@ -146,6 +149,21 @@ scpi_result_t scpi_diag_InformationCalibrationQ(scpi_t * context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_diag_InformationEepromQ(scpi_t * context) {
+    char buffer[64] = { 0 };
+
+    sprintf_P(buffer, PSTR("bytes_written=%lu"), (unsigned long)eeprom::num_bytes_written);
+    SCPI_ResultText(context, buffer);
+
+    sprintf_P(buffer, PSTR("pages_written=%lu"), (unsigned long)eeprom::num_pages_written);
+    SCPI_ResultText(context, buffer);
+
+    sprintf_P(buffer, PSTR("pages_skipped=%lu"), (unsigned long)eeprom::num_pages_skipped);
+    SCPI_ResultText(context, buffer);
+
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_diag_InformationProtectionQ(scpi_t * context) {
     char buffer[128] = { 0 };
 
@@ -194,6 +212,49 @@ scpi_result_t scpi_diag_InformationProtectionQ(scpi_t * context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_diag_InformationProtectionLogQ(scpi_t * context) {
+    Channel *channel = param_channel(context, FALSE, TRUE);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    char buffer[128] = { 0 };
+
+    // onset is micros() value, all the other times are in microseconds since onset
+    for (uint8_t i = 0; i < channel->getProtectionLogSize(); ++i) {
+        const Channel::ProtectionEvent &event = channel->getProtectionLogEvent(i);
+
+        switch (event.type) {
+        case Channel::PROTECTION_EVENT_OVP: strcpy_P(buffer, PSTR("ovp")); break;
+        case Channel::PROTECTION_EVENT_OCP: strcpy_P(buffer, PSTR("ocp")); break;
+        case Channel::PROTECTION_EVENT_OPP: strcpy_P(buffer, PSTR("opp")); break;
+        default:                            strcpy_P(buffer, PSTR("otp")); break;
+        }
+
+        sprintf_P(buffer + strlen(buffer), PSTR(" onset=%lu alarm=%lu trip=%lu output_off=%lu reg_set=%lu delay=%lu"),
+            (unsigned long)event.onset,
+            (unsigned long)(event.alarm - event.onset),
+            (unsigned long)(event.trip - event.onset),
+            (unsigned long)(event.output_off - event.onset),
+            (unsigned long)(event.reg_set - event.onset),
+            (unsigned long)event.delay);
+        SCPI_ResultText(context, buffer);
+    }
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_diag_InformationProtectionLogClear(scpi_t * context) {
+    Channel *channel = param_channel(context, FALSE, TRUE);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    channel->clearProtectionLog();
+
+    return SCPI_RES_OK;
+}
+
 const char *get_installed_str(bool installed) {
     if (installed)
         return "installed";
@@ -19,8 +19,11 @@
 #pragma once
 
 #define SCPI_DIAG_COMMANDS \
-    SCPI_COMMAND("DIAGnostic[:INFOrmation]:ADC?",         scpi_diag_InformationADCQ) \
-    SCPI_COMMAND("DIAGnostic[:INFOrmation]:CALibration?", scpi_diag_InformationCalibrationQ) \
-    SCPI_COMMAND("DIAGnostic[:INFOrmation]:PROTection?",  scpi_diag_InformationProtectionQ) \
-    SCPI_COMMAND("DIAGnostic[:INFOrmation]:TEST?",        scpi_diag_InformationTestQ) \
+    SCPI_COMMAND("DIAGnostic[:INFOrmation]:ADC?",                 scpi_diag_InformationADCQ) \
+    SCPI_COMMAND("DIAGnostic[:INFOrmation]:CALibration?",         scpi_diag_InformationCalibrationQ) \
+    SCPI_COMMAND("DIAGnostic[:INFOrmation]:EEPRom?",              scpi_diag_InformationEepromQ) \
+    SCPI_COMMAND("DIAGnostic[:INFOrmation]:PROTection?",          scpi_diag_InformationProtectionQ) \
+    SCPI_COMMAND("DIAGnostic[:INFOrmation]:PROTection:LOG?",      scpi_diag_InformationProtectionLogQ) \
+    SCPI_COMMAND("DIAGnostic[:INFOrmation]:PROTection:LOG:CLEar", scpi_diag_InformationProtectionLogClear) \
+    SCPI_COMMAND("DIAGnostic[:INFOrmation]:TEST?",                scpi_diag_InformationTestQ) \
 
@@ -0,0 +1,109 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2015 Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+#include "psu.h"
+#include <scpi-parser.h>
+#include "scpi_psu.h"
+#include "scpi_form.h"
+
+namespace eez {
+namespace psu {
+namespace scpi {
+
+////////////////////////////////////////////////////////////////////////////////
+
+static scpi_choice_def_t data_format_choice[] = {
+    { "ASCii", DATA_FORMAT_ASCII },
+    { "REAL", DATA_FORMAT_REAL32 },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+static scpi_choice_def_t byte_order_choice[] = {
+    { "NORMal", BYTE_ORDER_NORMAL },
+    { "SWAPped", BYTE_ORDER_SWAPPED },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+scpi_result_t scpi_form_Data(scpi_t * context) {
+    int32_t format;
+    if (!SCPI_ParamChoice(context, data_format_choice, &format, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+
+    // <length> is number of significant digits for ASCii (ignored)
+    // and number of bits for REAL, where only 32 is supported
+    int32_t length;
+    if (SCPI_ParamInt(context, &length, FALSE)) {
+        if (format == DATA_FORMAT_REAL32 && length != 32) {
+            SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+            return SCPI_RES_ERR;
+        }
+    }
+    else if (SCPI_ParamErrorOccurred(context)) {
+        return SCPI_RES_ERR;
+    }
+
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    psu_context->data_format = (uint8_t)format;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_form_DataQ(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    if (psu_context->data_format == DATA_FORMAT_REAL32) {
+        SCPI_ResultCharacters(context, "REAL,32", 7);
+    }
+    else {
+        SCPI_ResultCharacters(context, "ASC", 3);
+    }
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_form_Border(scpi_t * context) {
+    int32_t byte_order;
+    if (!SCPI_ParamChoice(context, byte_order_choice, &byte_order, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    psu_context->byte_order = (uint8_t)byte_order;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_form_BorderQ(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    if (psu_context->byte_order == BYTE_ORDER_SWAPPED) {
+        SCPI_ResultCharacters(context, "SWAP", 4);
+    }
+    else {
+        SCPI_ResultCharacters(context, "NORM", 4);
+    }
+
+    return SCPI_RES_OK;
+}
+
+}
+}
+} // namespace eez::psu::scpi
@@ -33,11 +33,7 @@ scpi_result_t scpi_meas_CurrentQ(scpi_t * context) {
         return SCPI_RES_ERR;
     }
 
-    char buffer[256] = { 0 };
-    util::strcatFloat(buffer, channel->i.mon);
-    SCPI_ResultCharacters(context, buffer, strlen(buffer));
-
-    return SCPI_RES_OK;
+    return result_float(context, channel->i.mon);
 }
 
 scpi_result_t scpi_meas_PowerQ(scpi_t * context) {
@@ -46,11 +42,7 @@ scpi_result_t scpi_meas_PowerQ(scpi_t * context) {
         return SCPI_RES_ERR;
     }
 
-    char buffer[256] = { 0 };
-    util::strcatFloat(buffer, channel->u.mon * channel->i.mon);
-    SCPI_ResultCharacters(context, buffer, strlen(buffer));
-
-    return SCPI_RES_OK;
+    return result_float(context, channel->u.mon * channel->i.mon);
 }
 
 scpi_result_t scpi_meas_VoltageQ(scpi_t * context) {
@@ -59,11 +51,7 @@ scpi_result_t scpi_meas_VoltageQ(scpi_t * context) {
         return SCPI_RES_ERR;
     }
 
-    char buffer[256] = { 0 };
-    util::strcatFloat(buffer, channel->u.mon);
-    SCPI_ResultCharacters(context, buffer, strlen(buffer));
-
-    return SCPI_RES_OK;
+    return result_float(context, channel->u.mon);
 }
 
 scpi_result_t scpi_meas_TemperatureQ(scpi_t * context) {
@@ -75,13 +63,135 @@ scpi_result_t scpi_meas_TemperatureQ(scpi_t * context) {
         sensor = temp_sensor::MAIN;
     }
 
-    char buffer[256] = { 0 };
-    util::strcatFloat(buffer, temperature::measure((temp_sensor::Type)sensor));
-    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+    return result_float(context, temperature::measure((temp_sensor::Type)sensor));
+}
+
+/// Voltage, current and power of the channels given as parameters
+/// (all channels if none), e.g. MEAS:ALL? CH1,CH2 -> U1,I1,P1,U2,I2,P2.
+scpi_result_t scpi_meas_AllQ(scpi_t * context) {
+    int channels[CH_NUM];
+    int num_channels = 0;
+
+    int32_t ch;
+    while (num_channels < CH_NUM && SCPI_ParamChoice(context, channel_choice, &ch, FALSE)) {
+        channels[num_channels++] = ch;
+    }
+    if (SCPI_ParamErrorOccurred(context)) {
+        return SCPI_RES_ERR;
+    }
+
+    if (num_channels == 0) {
+        for (int i = 0; i < CH_NUM; ++i) {
+            channels[i] = i + 1;
+        }
+        num_channels = CH_NUM;
+    }
+
+    for (int i = 0; i < num_channels; ++i) {
+        if (!check_channel(context, channels[i])) {
+            return SCPI_RES_ERR;
+        }
+    }
+
+    float values[3 * CH_NUM];
+
+    // ADC interrupt routine can't update any value while we are taking them,
+    // so all of them are from the same instant
+    noInterrupts();
+    for (int i = 0; i < num_channels; ++i) {
+        Channel &channel = Channel::get(channels[i] - 1);
+        values[3 * i] = channel.u.mon;
+        values[3 * i + 1] = channel.i.mon;
+    }
+    interrupts();
+
+    for (int i = 0; i < num_channels; ++i) {
+        values[3 * i + 2] = values[3 * i] * values[3 * i + 1];
+    }
+
+    return result_float_array(context, values, 3 * num_channels);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+enum HistoryValue {
+    HISTORY_VOLTAGE,
+    HISTORY_CURRENT,
+    HISTORY_TIME,
+    /// time, voltage and current of each sample
+    HISTORY_ALL
+};
+
+/// Send the channel sample history as IEEE 488.2 arbitrary block of 32-bit floats
+/// (in FORMat:BORDer byte order), from the oldest to the newest sample. Time is in seconds since the oldest sample.
+/// All the values sent by one query are from the same snapshot of the history,
+/// use HISTORY_ALL to get matching time, voltage and current values.
+static scpi_result_t fetch_array(scpi_t *context, HistoryValue value) {
+    Channel *channel = param_channel(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    channel->freezeHistory(true);
+
+    uint16_t size = channel->getHistorySize();
+    uint32_t time0 = size > 0 ? channel->getHistorySample(0).time : 0;
+
+    uint16_t values_per_sample = value == HISTORY_ALL ? 3 : 1;
+
+    SCPI_ResultArbitraryBlockHeader(context, size * values_per_sample * sizeof(float));
+
+    float buffer[16];
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < size; ++i) {
+        const Channel::Sample &sample = channel->getHistorySample(i);
+
+        if (value == HISTORY_VOLTAGE) {
+            buffer[n++] = util::q16ToFloat(sample.u);
+        }
+        else if (value == HISTORY_CURRENT) {
+            buffer[n++] = util::q16ToFloat(sample.i);
+        }
+        else if (value == HISTORY_TIME) {
+            buffer[n++] = (sample.time - time0) / 1000000.0f;
+        }
+        else {
+            buffer[n++] = (sample.time - time0) / 1000000.0f;
+            buffer[n++] = util::q16ToFloat(sample.u);
+            buffer[n++] = util::q16ToFloat(sample.i);
+        }
+
+        if (n + values_per_sample > sizeof(buffer) / sizeof(float) || i == size - 1) {
+            result_float_block_data(context, buffer, n);
+            n = 0;
+        }
+    }
+
+    if (size == 0) {
+        SCPI_ResultArbitraryBlockData(context, buffer, 0);
+    }
+
+    channel->freezeHistory(false);
 
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_fetc_ArrayVoltageQ(scpi_t * context) {
+    return fetch_array(context, HISTORY_VOLTAGE);
+}
+
+scpi_result_t scpi_fetc_ArrayCurrentQ(scpi_t * context) {
+    return fetch_array(context, HISTORY_CURRENT);
+}
+
+scpi_result_t scpi_fetc_ArrayTimeQ(scpi_t * context) {
+    return fetch_array(context, HISTORY_TIME);
+}
+
+scpi_result_t scpi_fetc_ArrayAllQ(scpi_t * context) {
+    return fetch_array(context, HISTORY_ALL);
+}
+
 }
 }
 } // namespace eez::psu::scpi
\ No newline at end of file
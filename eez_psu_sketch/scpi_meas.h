@@ -23,4 +23,9 @@
     SCPI_COMMAND("MEASure[:SCALar]:CURRent[:DC]?", scpi_meas_CurrentQ) \
     SCPI_COMMAND("MEASure[:SCALar]:POWer[:DC]?", scpi_meas_PowerQ) \
     SCPI_COMMAND("MEASure[:SCALar]:TEMPerature[:THERmistor][:DC]?", scpi_meas_TemperatureQ) \
+    SCPI_COMMAND("MEASure[:SCALar]:ALL[:DC]?", scpi_meas_AllQ) \
+    SCPI_COMMAND("FETCh:ARRay[:VOLTage][:DC]?", scpi_fetc_ArrayVoltageQ) \
+    SCPI_COMMAND("FETCh:ARRay:CURRent[:DC]?", scpi_fetc_ArrayCurrentQ) \
+    SCPI_COMMAND("FETCh:ARRay:TIME?", scpi_fetc_ArrayTimeQ) \
+    SCPI_COMMAND("FETCh:ARRay:ALL[:DC]?", scpi_fetc_ArrayAllQ) \
 
@@ -25,7 +25,7 @@ namespace scpi {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-static scpi_choice_def_t channel_choice[] = {
+scpi_choice_def_t channel_choice[] = {
     { "CH1", 1 },
     { "CH2", 2 },
     SCPI_CHOICE_LIST_END /* termination of option list */
@@ -338,13 +338,72 @@ bool get_duration_from_param(scpi_t *context, const scpi_number_t &param, float
     return true;
 }
 
-scpi_result_t result_float(scpi_t * context, float value) {
+static void float_to_bytes(float value, uint8_t byte_order, uint8_t *bytes) {
+    uint32_t u;
+    memcpy(&u, &value, sizeof(u));
+    if (byte_order == BYTE_ORDER_SWAPPED) {
+        bytes[0] = (uint8_t)u;
+        bytes[1] = (uint8_t)(u >> 8);
+        bytes[2] = (uint8_t)(u >> 16);
+        bytes[3] = (uint8_t)(u >> 24);
+    }
+    else {
+        bytes[0] = (uint8_t)(u >> 24);
+        bytes[1] = (uint8_t)(u >> 16);
+        bytes[2] = (uint8_t)(u >> 8);
+        bytes[3] = (uint8_t)u;
+    }
+}
+
+scpi_result_t result_float(scpi_t * context, float value, bool full_precision) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    if (psu_context->data_format == DATA_FORMAT_REAL32) {
+        uint8_t bytes[4];
+        float_to_bytes(value, psu_context->byte_order, bytes);
+        SCPI_ResultArbitraryBlock(context, bytes, sizeof(bytes));
+        return SCPI_RES_OK;
+    }
+
+    if (full_precision) {
+        SCPI_ResultFloat(context, value);
+        return SCPI_RES_OK;
+    }
+
     char buffer[32] = { 0 };
     util::strcatFloat(buffer, value);
     SCPI_ResultCharacters(context, buffer, strlen(buffer));
     return SCPI_RES_OK;
 }
 
+scpi_result_t result_float_array(scpi_t * context, const float *values, size_t count) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    if (psu_context->data_format == DATA_FORMAT_REAL32) {
+        SCPI_ResultArbitraryBlockHeader(context, count * 4);
+        result_float_block_data(context, values, count);
+        return SCPI_RES_OK;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        result_float(context, values[i]);
+    }
+    return SCPI_RES_OK;
+}
+
+void result_float_block_data(scpi_t * context, const float *values, size_t count) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    uint8_t bytes[32];
+    size_t n = 0;
+    for (size_t i = 0; i < count; ++i) {
+        float_to_bytes(values[i], psu_context->byte_order, bytes + n);
+        n += 4;
+        if (n == sizeof(bytes) || i == count - 1) {
+            SCPI_ResultArbitraryBlockData(context, bytes, n);
+            n = 0;
+        }
+    }
+}
+
 bool get_profile_location_param(scpi_t * context, int &location, bool all_locations) {
     int32_t param;
     if (!SCPI_ParamInt(context, &param, true)) {
@@ -24,6 +24,7 @@ namespace eez {
 namespace psu {
 namespace scpi {
 
+extern scpi_choice_def_t channel_choice[];
 extern scpi_choice_def_t main_temp_sensor_choice[];
 extern scpi_choice_def_t channel_temp_sensor_choice[];
 extern scpi_choice_def_t all_temp_sensor_choice[];
@@ -44,7 +45,15 @@ bool get_power_from_param(scpi_t *context, const scpi_number_t &param, float &va
 bool get_temperature_from_param(scpi_t *context, const scpi_number_t &param, float &value, float min, float max, float def);
 bool get_duration_from_param(scpi_t *context, const scpi_number_t &param, float &value, float min, float max, float def);
 
-scpi_result_t result_float(scpi_t * context, float value);
+/// Send float query result in the data format (FORMat[:DATA]) of the SCPI context.
+/// In ASCii format the value is rounded to FLOAT_TO_STR_PREC decimals,
+/// unless full_precision is set (e.g. for delays given in milliseconds).
+scpi_result_t result_float(scpi_t * context, float value, bool full_precision = false);
+/// Send float values in the data format of the SCPI context:
+/// comma separated in ASCii, single arbitrary block in REAL.
+scpi_result_t result_float_array(scpi_t * context, const float *values, size_t count);
+/// Send float values as part of arbitrary block, in the byte order (FORMat:BORDer) of the SCPI context.
+void result_float_block_data(scpi_t * context, const float *values, size_t count);
 bool get_profile_location_param(scpi_t * context, int &location, bool all_locations = false);
 
 }
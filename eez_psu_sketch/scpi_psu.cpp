@@ -24,6 +24,7 @@
 #include "scpi_core.h"
 #include "scpi_debug.h"
 #include "scpi_diag.h"
+#include "scpi_form.h"
 #include "scpi_inst.h"
 #include "scpi_meas.h"
 #include "scpi_mem.h"
@@ -51,6 +52,7 @@ namespace scpi {
     SCPI_CORE_COMMANDS \
     SCPI_DEBUG_COMMANDS \
     SCPI_DIAG_COMMANDS \
+    SCPI_FORM_COMMANDS \
     SCPI_INST_COMMANDS \
     SCPI_MEAS_COMMANDS \
     SCPI_MEM_COMMANDS \
@@ -86,6 +88,12 @@ static const scpi_command_t scpi_commands[] = {
 
 #endif
 
+#if USE_COMMAND_INDEX
+static scpi_cmd_index_entry_t scpi_cmd_index_entries[SCPI_PARSER_COMMAND_INDEX_SIZE];
+static scpi_cmd_index_t scpi_cmd_index;
+static bool scpi_cmd_index_initialized = false;
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void init(scpi_t &scpi_context,
@@ -101,27 +109,107 @@ void init(scpi_t &scpi_context,
         input_buffer, input_buffer_length, error_queue_data, error_queue_size);
 
     scpi_context.user_context = &scpi_psu_context;
+    resetDataFormat(scpi_context);
+
+#if USE_COMMAND_INDEX
+    if (scpi_cmd_index_initialized) {
+        SCPI_SetCommandIndex(&scpi_context, scpi_cmd_index.count > 0 ? &scpi_cmd_index : 0);
+    }
+    else {
+        scpi_cmd_index_initialized = true;
+        if (!SCPI_InitCommandIndex(&scpi_context, &scpi_cmd_index, scpi_cmd_index_entries, SCPI_PARSER_COMMAND_INDEX_SIZE)) {
+            DebugTrace("SCPI command index too small");
+        }
+    }
+#endif
 }
 
-void input(scpi_t &scpi_context, char ch) {
-    //if (ch < 0 || ch > 127) {
-    //    // non ASCII, call parser now
-    //    SCPI_Input(&scpi_context, 0, 0);
-    //    return;
-    //}
+void resetDataFormat(scpi_t &scpi_context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)scpi_context.user_context;
+    psu_context->data_format = DATA_FORMAT_ASCII;
+    psu_context->byte_order = BYTE_ORDER_NORMAL;
+}
 
-    int result = SCPI_Input(&scpi_context, &ch, 1);
-    if (result == -1) {
-        // TODO we need better buffer overrun handling here
+void input(scpi_t &scpi_context, const char *buffer, size_t length) {
+    SCPI_Input(&scpi_context, buffer, length);
+}
 
-        // call parser now
-        SCPI_Input(&scpi_context, 0, 0);
+void resumeInput(scpi_t &scpi_context) {
+    SCPI_InputResume(&scpi_context);
+}
 
-        // input buffer is now empty, feed it
-        SCPI_Input(&scpi_context, &ch, 1);
+#ifdef EEZ_PSU_SIMULATOR
+
+static size_t benchmark_write(scpi_t *context, const char *data, size_t len) {
+    return len;
+}
+
+/// Queries without side effects, spread over the whole command list.
+static const char *benchmark_commands[] = {
+    "APPL?",
+    "CAL:STAT?",
+    "*STB?",
+    "DIAG:PROT?",
+    "INST:NSEL?",
+    "MEAS:VOLT?",
+    "MEAS:CURR? CH1",
+    "MEM:NST?",
+    "OUTP?",
+    "SIMU:LOAD?",
+    "SOUR1:VOLT?",
+    "CURR:STEP?",
+    "POW:PROT:TRIP?",
+    "STAT:QUES:COND?",
+    "STAT:OPER:INST:ISUM2:ENAB?",
+    "SYST:VERS?",
+    "SYST:TEMP:PROT:TRIP?",
+    "SYST:ERR?",
+};
+
+static float benchmarkRun(scpi_t &context, uint32_t iterations) {
+    char line[64];
+    uint32_t count = 0;
+
+    // micros() doesn't advance in the virtual time mode
+    uint64_t start = simulator::getRealTime();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        for (size_t j = 0; j < sizeof(benchmark_commands) / sizeof(benchmark_commands[0]); ++j) {
+            strcpy(line, benchmark_commands[j]);
+            SCPI_Parse(&context, line, strlen(line));
+            ++count;
+        }
     }
+    uint64_t elapsed = simulator::getRealTime() - start;
+
+    return elapsed > 0 ? count * 1000000.0f / elapsed : 0;
+}
+
+void benchmarkCommandDispatch(uint32_t iterations, float &linear, float &indexed) {
+    scpi_reg_val_t scpi_psu_regs[SCPI_PSU_REG_COUNT];
+    scpi_psu_t scpi_psu_context = { scpi_psu_regs, 1 };
+    scpi_interface_t scpi_interface = { 0, benchmark_write, 0, 0, 0 };
+    char scpi_input_buffer[SCPI_PARSER_INPUT_BUFFER_LENGTH];
+    int16_t error_queue_data[SCPI_PARSER_ERROR_QUEUE_SIZE + 1];
+    scpi_t scpi_context;
+
+    init(scpi_context,
+        scpi_psu_context,
+        &scpi_interface,
+        scpi_input_buffer, SCPI_PARSER_INPUT_BUFFER_LENGTH,
+        error_queue_data, SCPI_PARSER_ERROR_QUEUE_SIZE + 1);
+
+    indexed = benchmarkRun(scpi_context, iterations);
+
+#if USE_COMMAND_INDEX
+    SCPI_SetCommandIndex(&scpi_context, 0);
+    linear = benchmarkRun(scpi_context, iterations);
+#else
+    linear = indexed;
+#endif
 }
 
+#endif
+
 void printError(int_fast16_t err) {
     sound::playBeep();
 
@@ -26,10 +26,27 @@ namespace psu {
 /// SCPI commands.
 namespace scpi {
 
+/// Data format of numeric query results, set with FORMat[:DATA].
+enum DataFormat {
+    DATA_FORMAT_ASCII,
+    /// IEEE 754 single precision in definite length arbitrary block
+    DATA_FORMAT_REAL32
+};
+
+/// Byte order of binary query results, set with FORMat:BORDer.
+enum ByteOrder {
+    /// most significant byte first
+    BYTE_ORDER_NORMAL,
+    /// least significant byte first
+    BYTE_ORDER_SWAPPED
+};
+
 /// EEZ PSU specific SCPI parser context data.
 struct scpi_psu_t {
     scpi_reg_val_t *registers;
     uint8_t selected_channel_index;
+    uint8_t data_format;
+    uint8_t byte_order;
 };
 
 void init(scpi_t &scpi_context,
@@ -40,9 +57,22 @@ void init(scpi_t &scpi_context,
     int16_t *error_queue_data,
     int16_t error_queue_size);
 
-void input(scpi_t &scpi_context, char ch);
+/// Set FORMat settings of SCPI context to the *RST state.
+void resetDataFormat(scpi_t &scpi_context);
+
+/// Pass block of received data to SCPI parser.
+void input(scpi_t &scpi_context, const char *buffer, size_t length);
+
+/// Execute the input kept in SCPI parser input buffer while power up was in progress.
+void resumeInput(scpi_t &scpi_context);
 
 void printError(int_fast16_t err);
+
+#ifdef EEZ_PSU_SIMULATOR
+/// Parse a set of queries using the sequential command search and the command index.
+/// Results are in commands per second.
+void benchmarkCommandDispatch(uint32_t iterations, float &linear, float &indexed);
+#endif
 }
 }
 } // namespace eez::psu::scpi
@@ -230,6 +230,24 @@ void reg_set_ques_bit(scpi_t *context, int bit_mask, bool on) {
     }
 }
 
+void reg_set_oper_bit(scpi_t *context, int bit_mask, bool on) {
+    scpi_reg_val_t val = reg_get(context, SCPI_PSU_REG_OPER_COND);
+    if (on) {
+        if (!(val & bit_mask)) {
+            reg_set(context, SCPI_PSU_REG_OPER_COND, val | bit_mask);
+
+            // set event on raising condition
+            val = SCPI_RegGet(context, SCPI_REG_OPER);
+            SCPI_RegSet(context, SCPI_REG_OPER, val | bit_mask);
+        }
+    }
+    else {
+        if (val & bit_mask) {
+            reg_set(context, SCPI_PSU_REG_OPER_COND, val & ~bit_mask);
+        }
+    }
+}
+
 void reg_set_ques_isum_bit(scpi_t *context, Channel *channel, int bit_mask, bool on) {
     scpi_psu_reg_name_t reg_name = channel->index == 1 ? SCPI_PSU_CH_REG_QUES_INST_ISUM_COND1 : SCPI_PSU_CH_REG_QUES_INST_ISUM_COND2;
     scpi_reg_val_t val = reg_get(context, reg_name);
@@ -36,6 +36,7 @@ namespace scpi {
 //
 #define OPER_GROUP_PARALLEL (1 << 8)    /* GROUp PARAllel */
 #define OPER_GROUP_SERIAL   (1 << 9)    /* GROUp SERIal */
+#define OPER_PWRUP          (1 << 10)   /* POWer UP sequence in progress */
 #define OPER_ISUM           (1 << 13)   /* INSTrument Summary */
 
 //
@@ -114,6 +115,7 @@ int reg_get_ques_isum_bit_mask_for_channel_protection_value(Channel *channel, Ch
 int reg_get_ques_isum_bit_mask_for_channel_protection_value(temp_sensor::Type sensor);
 
 void reg_set_ques_bit(scpi_t *context, int bit_mask, bool on);
+void reg_set_oper_bit(scpi_t *context, int bit_mask, bool on);
 void reg_set_ques_isum_bit(scpi_t * context, Channel *channel, int bit_mask, bool on);
 
 void reg_set_oper_isum_bit(scpi_t * context, Channel *channel, int bit_mask, bool on);
@@ -129,9 +129,7 @@ scpi_result_t set_delay(scpi_t *context, float &delay_var, float min, float max,
 }
 
 scpi_result_t get_delay(scpi_t *context, float delay) {
-    SCPI_ResultFloat(context, delay);
-
-    return SCPI_RES_OK;
+    return result_float(context, delay, true);
 }
 
 scpi_result_t set_state(scpi_t *context, Channel *channel, int type) {
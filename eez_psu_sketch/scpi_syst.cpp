@@ -299,9 +299,7 @@ scpi_result_t scpi_syst_TempProtectionDelayQ(scpi_t * context) {
         sensor = temp_sensor::MAIN;
     }
 
-    SCPI_ResultFloat(context, temperature::prot_conf[sensor].delay);
-
-    return SCPI_RES_OK;
+    return result_float(context, temperature::prot_conf[sensor].delay, true);
 }
 
 scpi_result_t scpi_syst_TempProtectionTrippedQ(scpi_t * context) {
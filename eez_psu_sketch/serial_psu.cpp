@@ -62,6 +62,12 @@ scpi_result_t SCPI_Reset(scpi_t *context) {
     return psu::reset() ? SCPI_RES_OK : SCPI_RES_ERR;
 }
 
+scpi_bool_t SCPI_Hold(scpi_t *context) {
+    // program message units received after the one which started power up
+    // are kept in the input buffer until power up is finished
+    return psu::isPowerUpInProgress();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 scpi_reg_val_t scpi_psu_regs[SCPI_PSU_REG_COUNT];
@@ -73,6 +79,7 @@ scpi_interface_t scpi_interface = {
     SCPI_Control,
     SCPI_Flush,
     SCPI_Reset,
+    SCPI_Hold,
 };
 
 char scpi_input_buffer[SCPI_PARSER_INPUT_BUFFER_LENGTH];
@@ -104,9 +111,23 @@ void init() {
 }
 
 void tick(unsigned long tick_usec) {
-    while (Serial.available()) {
-        char ch = (char)Serial.read();
-        input(scpi_context, ch);
+    // input is queued in serial buffer until power up is finished
+    if (psu::isPowerUpInProgress()) {
+        return;
+    }
+
+    resumeInput(scpi_context);
+
+    char buffer[SCPI_PARSER_INPUT_CHUNK_SIZE];
+    int size;
+    while (!psu::isPowerUpInProgress() && (size = Serial.available()) > 0) {
+        if (size > SCPI_PARSER_INPUT_CHUNK_SIZE) {
+            size = SCPI_PARSER_INPUT_CHUNK_SIZE;
+        }
+        for (int i = 0; i < size; ++i) {
+            buffer[i] = (char)Serial.read();
+        }
+        input(scpi_context, buffer, size);
     }
 }
 
@@ -132,46 +132,93 @@ int beep_tune[] = {
     -1 // end!
 };
 
-int *g_play_tune = 0;
-
-static void play_tune(int *tune) {
-    // iterate over the notes of the melody:
-    for (int index = 0; tune[index] != -1; index += 2) {
-        // to calculate the note duration, take one second
-        // divided by the note type.
-        // e.g. quarter note = 1000 / 4, eighth note = 1000/8, etc.
-        int noteDuration = 1000 / tune[index + 1];
-        buzzer::tone(tune[index], noteDuration); // Arduino pin A1 is PF6 (Pin 37) assigned to BUZZER
-
-        // to distinguish the notes, set a minimum time between them.
-        // the note's duration + 30% seems to work well:
-        int pauseBetweenNotes = (int)(noteDuration * 1.30);
-        delay(pauseBetweenNotes);
+/// Max. number of tunes waiting for the current tune to finish.
+static const int TUNE_QUEUE_SIZE = 4;
+
+static int *g_tune_queue[TUNE_QUEUE_SIZE];
+static int g_tune_queue_head = 0;
+static int g_tune_queue_count = 0;
+
+/// Tune currently played, note index and time when the next note should start.
+static int *g_tune = 0;
+static int g_note_index;
+static unsigned long g_next_note_usec;
+
+static void enqueue_tune(int *tune) {
+    // don't repeat the same tune if it is already waiting to be played
+    if (g_tune_queue_count > 0 && g_tune_queue[(g_tune_queue_head + g_tune_queue_count - 1) % TUNE_QUEUE_SIZE] == tune) {
+        return;
+    }
+
+    if (g_tune_queue_count == TUNE_QUEUE_SIZE) {
+        return;
     }
+
+    g_tune_queue[(g_tune_queue_head + g_tune_queue_count) % TUNE_QUEUE_SIZE] = tune;
+    ++g_tune_queue_count;
+}
+
+static int *dequeue_tune() {
+    if (g_tune_queue_count == 0) {
+        return 0;
+    }
+
+    int *tune = g_tune_queue[g_tune_queue_head];
+    g_tune_queue_head = (g_tune_queue_head + 1) % TUNE_QUEUE_SIZE;
+    --g_tune_queue_count;
+    return tune;
 }
 
 void tick(unsigned long tick_usec) {
-    if (g_play_tune) {
-        play_tune(g_play_tune);
-        g_play_tune = 0;
+    if (!g_tune) {
+        g_tune = dequeue_tune();
+        if (!g_tune) {
+            return;
+        }
+        g_note_index = 0;
+        g_next_note_usec = tick_usec;
+    }
+
+    if ((long)(tick_usec - g_next_note_usec) < 0) {
+        // previous note is still playing
+        return;
+    }
+
+    if (g_tune[g_note_index] == -1) {
+        // tune is finished, next one (if any) is started in the next tick
+        g_tune = 0;
+        return;
     }
+
+    // to calculate the note duration, take one second
+    // divided by the note type.
+    // e.g. quarter note = 1000 / 4, eighth note = 1000/8, etc.
+    int noteDuration = 1000 / g_tune[g_note_index + 1];
+    buzzer::tone(g_tune[g_note_index], noteDuration); // Arduino pin A1 is PF6 (Pin 37) assigned to BUZZER
+
+    // to distinguish the notes, set a minimum time between them.
+    // the note's duration + 30% seems to work well:
+    unsigned long pauseBetweenNotes = (unsigned long)(noteDuration * 1300UL);
+    g_next_note_usec = tick_usec + pauseBetweenNotes;
+
+    g_note_index += 2;
 }
 
 void playPowerUp() {
     if (persist_conf::isBeepEnabled()) {
-        g_play_tune = power_up_tune;
+        enqueue_tune(power_up_tune);
     }
 }
 
 void playPowerDown() {
     if (persist_conf::isBeepEnabled()) {
-        g_play_tune = power_down_tune;
+        enqueue_tune(power_down_tune);
     }
 }
 
 void playBeep(bool force) {
     if (force || persist_conf::isBeepEnabled()) {
-        g_play_tune = beep_tune;
+        enqueue_tune(beep_tune);
     }
 }
 
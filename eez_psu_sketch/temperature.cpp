@@ -49,22 +49,38 @@ static void set_otp_reg(temp_sensor::Type sensor, bool on) {
     }
 }
 
-static void sensor_protection_enter(temp_sensor::Type sensor) {
+static void sensor_protection_enter(temp_sensor::Type sensor, unsigned long onset_tick) {
+    uint32_t trip = micros();
+
     sensor_otp_tripped[sensor] = true;
 
+    // channels switched off by this trip, these get an entry in the protection event log
+    bool switched_off[CH_MAX] = { false };
+
     if (sensor == temp_sensor::MAIN) {
         for (int i = 0; i < CH_NUM; ++i) {
+            switched_off[i] = Channel::get(i).isOutputEnabled();
             Channel::get(i).outputEnable(false);
         }
 
         psu::powerDownBySensor();
     }
     else {
-        Channel::get(sensor == temp_sensor::S1 || sensor == temp_sensor::BAT1 ? 0 : 1).outputEnable(false);
+        int i = sensor == temp_sensor::S1 || sensor == temp_sensor::BAT1 ? 0 : 1;
+        switched_off[i] = Channel::get(i).isOutputEnabled();
+        Channel::get(i).outputEnable(false);
     }
 
     set_otp_reg(sensor, true);
 
+    uint32_t reg_set = micros();
+    uint32_t delay = prot_conf[sensor].delay > 0 ? (uint32_t)(prot_conf[sensor].delay * 1000000UL) : 0;
+    for (int i = 0; i < CH_NUM; ++i) {
+        if (switched_off[i]) {
+            Channel::get(i).logProtectionEvent(Channel::PROTECTION_EVENT_OTP, onset_tick, onset_tick, trip, reg_set, delay);
+        }
+    }
+
     sound::playBeep();
 }
 
@@ -79,7 +95,7 @@ static void sensor_protection_check(unsigned long tick_usec, temp_sensor::Type s
             if (sensor_otp_alarmed[sensor]) {
                 if (tick_usec - sensor_otp_alarmed_started_tick[sensor] >= delay * 1000000UL) {
                     sensor_otp_alarmed[sensor] = 0;
-                    sensor_protection_enter(sensor);
+                    sensor_protection_enter(sensor, sensor_otp_alarmed_started_tick[sensor]);
                 }
             }
             else {
@@ -88,7 +104,7 @@ static void sensor_protection_check(unsigned long tick_usec, temp_sensor::Type s
             }
         }
         else {
-            sensor_protection_enter(sensor);
+            sensor_protection_enter(sensor, tick_usec);
         }
     }
     else {
@@ -109,7 +109,7 @@ If the inner loop is strung out (approx. 5*8 = 40 instructions),
 it would take about 6 + 46n instructions.
 */
 
-uint32_t crc32(const uint8_t *mem_block, size_t block_size) {
+uint32_t crc32Bitwise(const uint8_t *mem_block, size_t block_size) {
     uint32_t crc = 0xFFFFFFFF;
     for (size_t i = 0; i < block_size; ++i) {
         uint32_t byte = mem_block[i];            // Get next byte.
@@ -122,6 +122,148 @@ uint32_t crc32(const uint8_t *mem_block, size_t block_size) {
     return ~crc;
 }
 
+#if CRC32_ENGINE == CRC32_TABLE || defined(EEZ_PSU_SIMULATOR)
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+#ifndef pgm_read_dword
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#endif
+
+/// Same polynomial as in crc32Bitwise, one entry for each byte value.
+static const uint32_t crc32_table[256] PROGMEM = {
+    0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
+    0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
+    0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
+    0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+    0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
+    0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
+    0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
+    0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+    0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
+    0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
+    0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
+    0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+    0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
+    0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+    0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
+    0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+    0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
+    0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
+    0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
+    0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+    0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
+    0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
+    0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
+    0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+    0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
+    0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
+    0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
+    0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+    0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
+    0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
+    0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
+    0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+    0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
+    0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
+    0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
+    0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+    0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
+    0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
+    0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
+    0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+    0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693,
+    0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+    0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+};
+
+uint32_t crc32Table(const uint8_t *mem_block, size_t block_size) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < block_size; ++i) {
+        crc = (crc >> 8) ^ pgm_read_dword(&crc32_table[(crc ^ mem_block[i]) & 0xFF]);
+    }
+    return ~crc;
+}
+
+#endif
+
+#if CRC32_ENGINE == CRC32_SLICE_BY_8 || defined(EEZ_PSU_SIMULATOR)
+
+/// Slice-by-8 tables, crc32_slice_table[0] is the ordinary byte table and
+/// crc32_slice_table[k][n] is CRC of byte n followed by k zero bytes.
+static uint32_t crc32_slice_table[8][256];
+static bool crc32_slice_table_init = false;
+
+static void initCrc32SliceTable() {
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; ++j) {
+            uint32_t mask = -(crc & 1);
+            crc = (crc >> 1) ^ (0xEDB88320 & mask);
+        }
+        crc32_slice_table[0][i] = crc;
+    }
+
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (int k = 1; k < 8; ++k) {
+            uint32_t crc = crc32_slice_table[k - 1][i];
+            crc32_slice_table[k][i] = (crc >> 8) ^ crc32_slice_table[0][crc & 0xFF];
+        }
+    }
+
+    crc32_slice_table_init = true;
+}
+
+uint32_t crc32SliceBy8(const uint8_t *mem_block, size_t block_size) {
+    if (!crc32_slice_table_init) {
+        initCrc32SliceTable();
+    }
+
+    uint32_t crc = 0xFFFFFFFF;
+
+    // process 8 bytes at once, words are assembled byte by byte
+    // so it doesn't depend on alignment and endianness
+    for (; block_size >= 8; block_size -= 8, mem_block += 8) {
+        uint32_t one = crc ^ (
+            (uint32_t)mem_block[0] |
+            ((uint32_t)mem_block[1] << 8) |
+            ((uint32_t)mem_block[2] << 16) |
+            ((uint32_t)mem_block[3] << 24));
+
+        crc =
+            crc32_slice_table[7][one & 0xFF] ^
+            crc32_slice_table[6][(one >> 8) & 0xFF] ^
+            crc32_slice_table[5][(one >> 16) & 0xFF] ^
+            crc32_slice_table[4][one >> 24] ^
+            crc32_slice_table[3][mem_block[4]] ^
+            crc32_slice_table[2][mem_block[5]] ^
+            crc32_slice_table[1][mem_block[6]] ^
+            crc32_slice_table[0][mem_block[7]];
+    }
+
+    for (; block_size > 0; --block_size) {
+        crc = (crc >> 8) ^ crc32_slice_table[0][(crc ^ *mem_block++) & 0xFF];
+    }
+
+    return ~crc;
+}
+
+#endif
+
+uint32_t crc32(const uint8_t *mem_block, size_t block_size) {
+#if CRC32_ENGINE == CRC32_TABLE
+    return crc32Table(mem_block, block_size);
+#elif CRC32_ENGINE == CRC32_SLICE_BY_8
+    return crc32SliceBy8(mem_block, block_size);
+#elif CRC32_ENGINE == CRC32_BITWISE
+    return crc32Bitwise(mem_block, block_size);
+#else
+#error "Unknown CRC32_ENGINE"
+#endif
+}
+
 uint8_t toBCD(uint8_t bin) {
     return ((bin / 10) << 4) | (bin % 10);
 }
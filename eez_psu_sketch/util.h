@@ -34,8 +34,21 @@ void strcatCurrent(char *str, float value);
 void strcatDuration(char *str, float value);
 void strcatLoad(char *str, float value);
 
+/// CRC32 (IEEE 802.3) of the message, using the engine selected with CRC32_ENGINE.
 uint32_t crc32(const uint8_t *message, size_t size);
 
+uint32_t crc32Bitwise(const uint8_t *message, size_t size);
+#if CRC32_ENGINE == CRC32_TABLE || defined(EEZ_PSU_SIMULATOR)
+uint32_t crc32Table(const uint8_t *message, size_t size);
+#endif
+#if CRC32_ENGINE == CRC32_SLICE_BY_8 || defined(EEZ_PSU_SIMULATOR)
+uint32_t crc32SliceBy8(const uint8_t *message, size_t size);
+#endif
+
+/// Q16.16 fixed point conversions.
+inline int32_t floatToQ16(float value) { return (int32_t)(value * 65536.0f + (value < 0 ? -0.5f : 0.5f)); }
+inline float q16ToFloat(int32_t value) { return value * (1.0f / 65536.0f); }
+
 uint8_t toBCD(uint8_t bin);
 uint8_t fromBCD(uint8_t bcd);
 
@@ -162,6 +162,338 @@ static scpi_bool_t processCommand(scpi_t * context) {
     return result;
 }
 
+#if USE_COMMAND_INDEX
+
+/* Key of the index entries matching any header, always sorted first */
+#define SCPI_CMD_INDEX_KEY_ANY 0
+
+/* Max. number of keys generated from one pattern */
+#define SCPI_CMD_INDEX_MAX_PATTERN_KEYS 8
+
+/**
+ * Compute index key from the leading characters of the mnemonic
+ * @param mnemonic
+ * @param len - length of mnemonic
+ * @return key or SCPI_CMD_INDEX_KEY_ANY if mnemonic is too short
+ */
+static uint16_t cmdIndexKey(const char * mnemonic, size_t len) {
+    uint16_t key = 0;
+    size_t i;
+
+    if (len < SCPI_CMD_INDEX_KEY_LEN) {
+        return SCPI_CMD_INDEX_KEY_ANY;
+    }
+
+    for (i = 0; i < SCPI_CMD_INDEX_KEY_LEN; i++) {
+        key = key * 31 + toupper((unsigned char) mnemonic[i]);
+    }
+
+    return key == SCPI_CMD_INDEX_KEY_ANY ? 1 : key;
+}
+
+/**
+ * Compute index keys of all mnemonics which can start a command matching
+ * the pattern. Leading optional nodes are expanded, e.g. [SOURce#]:VOLTage
+ * gives keys for "SOU" and "VOL". Key is computed from the short form of
+ * the mnemonic without numeric suffix.
+ * @param pattern
+ * @param keys - output keys
+ * @return number of keys
+ */
+static size_t cmdIndexPatternKeys(const char * pattern, uint16_t * keys) {
+    const char * p = pattern;
+    size_t n = 0;
+
+    while (1) {
+        int brackets = 0;
+        size_t node_len;
+        size_t short_len;
+
+        while (*p == '[') {
+            brackets++;
+            p++;
+        }
+        if (*p == ':') {
+            p++;
+        }
+
+        node_len = strcspn(p, ":[]?");
+        short_len = node_len;
+        if ((short_len > 0) && (p[short_len - 1] == '#')) {
+            short_len--;
+        }
+        short_len = patternSeparatorShortPos(p, short_len);
+
+        if (n == SCPI_CMD_INDEX_MAX_PATTERN_KEYS) {
+            /* too many optional nodes, pattern must be always checked */
+            keys[0] = SCPI_CMD_INDEX_KEY_ANY;
+            return 1;
+        }
+        keys[n++] = cmdIndexKey(p, short_len);
+
+        if (brackets == 0) {
+            break;
+        }
+
+        /* node was optional, command can also start with the node after it */
+        for (p += node_len; *p && brackets > 0; p++) {
+            if (*p == '[') {
+                brackets++;
+            } else if (*p == ']') {
+                brackets--;
+            }
+        }
+
+        if (*p == '\0' || *p == '?') {
+            break;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * Compute index key of the command header
+ * @param header
+ * @param len - length of header
+ * @return key
+ */
+static uint16_t cmdIndexHeaderKey(const char * header, size_t len) {
+    size_t i;
+
+    if ((len > 0) && (header[0] == ':')) {
+        header++;
+        len--;
+    }
+
+    for (i = 0; (i < len) && (header[i] != ':') && (header[i] != '?'); i++) {
+    }
+
+    return cmdIndexKey(header, i);
+}
+
+/**
+ * Find first index entry with key greater or equal to key
+ * @param index
+ * @param key
+ * @return position of entry or index->count
+ */
+static uint16_t cmdIndexLowerBound(const scpi_cmd_index_t * index, uint16_t key) {
+    uint16_t lo = 0;
+    uint16_t hi = index->count;
+
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+        if (index->entries[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/**
+ * Add index entries of one command pattern
+ * @return FALSE if there is not enough space in index
+ */
+static scpi_bool_t cmdIndexAdd(scpi_cmd_index_t * index, size_t entries_size, const char * pattern, uint16_t cmd, uint16_t pattern_offset) {
+    uint16_t keys[SCPI_CMD_INDEX_MAX_PATTERN_KEYS];
+    size_t n = cmdIndexPatternKeys(pattern, keys);
+    size_t i, j;
+
+    (void) pattern_offset;
+
+    for (i = 0; i < n; i++) {
+        /* skip duplicate keys */
+        for (j = 0; j < i && keys[j] != keys[i]; j++) {
+        }
+        if (j < i) {
+            continue;
+        }
+
+        if (index->count >= entries_size) {
+            return FALSE;
+        }
+
+        index->entries[index->count].key = keys[i];
+        index->entries[index->count].cmd = cmd;
+#if USE_FULL_PROGMEM_FOR_CMD_LIST
+        index->entries[index->count].pattern_offset = pattern_offset;
+#endif
+        index->count++;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Build command index for the context command list and attach it to the context.
+ * Index can be shared between contexts with the same command list,
+ * see SCPI_SetCommandIndex. If there is not enough space for all entries,
+ * index is not used and commands are searched sequentially.
+ *
+ * @param context
+ * @param index - index to build
+ * @param entries - storage for index entries
+ * @param entries_size - number of entries in storage
+ * @return TRUE if index was built
+ */
+scpi_bool_t SCPI_InitCommandIndex(scpi_t * context, scpi_cmd_index_t * index,
+        scpi_cmd_index_entry_t * entries, size_t entries_size) {
+    scpi_bool_t result = TRUE;
+    uint16_t i, j;
+
+    index->entries = entries;
+    index->count = 0;
+
+#if USE_64K_PROGMEM_FOR_CMD_LIST
+    PGM_P pattern;
+
+    for (i = 0; result && (pattern = (PGM_P)pgm_read_word(&context->cmdlist[i].pattern)) != 0; ++i) {
+        strncpy_P(context->param_list.cmd_pattern_s, pattern, SCPI_MAX_CMD_PATTERN_SIZE);
+        context->param_list.cmd_pattern_s[SCPI_MAX_CMD_PATTERN_SIZE] = '\0';
+        result = cmdIndexAdd(index, entries_size, context->param_list.cmd_pattern_s, i, 0);
+    }
+
+#elif USE_FULL_PROGMEM_FOR_CMD_LIST
+    uint_farptr_t p_cmd = context->cmdlist;
+    uint16_t pattern_offset = 0;
+    uint16_t pattern_length;
+
+    for (i = 0;
+         result && (pattern_length = pgm_read_word_far(p_cmd + offsetof(scpi_command_t, pattern))) != 0;
+         ++i, p_cmd += sizeof(scpi_command_t), pattern_offset += pattern_length)
+    {
+        strncpy_PF(context->param_list.cmd_pattern_s, context->cmdpatterns + pattern_offset, pattern_length);
+        context->param_list.cmd_pattern_s[pattern_length] = '\0';
+        result = cmdIndexAdd(index, entries_size, context->param_list.cmd_pattern_s, i, pattern_offset);
+    }
+
+#else
+    for (i = 0; result && context->cmdlist[i].pattern != NULL; i++) {
+        result = cmdIndexAdd(index, entries_size, context->cmdlist[i].pattern, i, 0);
+    }
+#endif
+
+    if (!result) {
+        index->count = 0;
+        SCPI_SetCommandIndex(context, NULL);
+        return FALSE;
+    }
+
+    /* stable sort by key, entries with the same key stay in command list order */
+    for (i = 1; i < index->count; i++) {
+        scpi_cmd_index_entry_t entry = index->entries[i];
+        for (j = i; j > 0 && index->entries[j - 1].key > entry.key; j--) {
+            index->entries[j] = index->entries[j - 1];
+        }
+        index->entries[j] = entry;
+    }
+
+    SCPI_SetCommandIndex(context, index);
+    return TRUE;
+}
+
+/**
+ * Attach already built command index to the context
+ * @param context
+ * @param index - index or NULL to search commands sequentially
+ */
+void SCPI_SetCommandIndex(scpi_t * context, const scpi_cmd_index_t * index) {
+    context->cmd_index = index;
+}
+
+/**
+ * Check command referenced by index entry and fill context->paramlist if it matches
+ * @param context
+ * @param entry
+ * @result TRUE if command matches
+ */
+static scpi_bool_t matchIndexEntry(scpi_t * context, const scpi_cmd_index_entry_t * entry, const char * header, int len) {
+#if USE_64K_PROGMEM_FOR_CMD_LIST
+    const scpi_command_t * cmd = &context->cmdlist[entry->cmd];
+
+    strncpy_P(context->param_list.cmd_pattern_s, (PGM_P)pgm_read_word(&cmd->pattern), SCPI_MAX_CMD_PATTERN_SIZE);
+    context->param_list.cmd_pattern_s[SCPI_MAX_CMD_PATTERN_SIZE] = '\0';
+
+    if (matchCommand(context->param_list.cmd_pattern_s, header, len, NULL, 0, 0)) {
+        context->param_list.cmd_s.callback = (scpi_command_callback_t)pgm_read_word(&cmd->callback);
+#if USE_COMMAND_TAGS 
+        context->param_list.cmd_s.tag = (int32_t)pgm_read_dword(&cmd->tag);
+#endif
+        return TRUE;
+    }
+
+#elif USE_FULL_PROGMEM_FOR_CMD_LIST
+    uint_farptr_t p_cmd = context->cmdlist + (uint_farptr_t)entry->cmd * sizeof(scpi_command_t);
+    uint16_t pattern_length = pgm_read_word_far(p_cmd + offsetof(scpi_command_t, pattern));
+
+    strncpy_PF(context->param_list.cmd_pattern_s, context->cmdpatterns + entry->pattern_offset, pattern_length);
+    context->param_list.cmd_pattern_s[pattern_length] = '\0';
+
+    if (matchCommand(context->param_list.cmd_pattern_s, header, len, NULL, 0, 0)) {
+        context->param_list.cmd_s.callback = (scpi_command_callback_t)pgm_read_word_far(p_cmd + offsetof(scpi_command_t, callback));
+#if USE_COMMAND_TAGS 
+        context->param_list.cmd_s.tag = (int32_t)pgm_read_dword_far(p_cmd + offsetof(scpi_command_t, tag));
+#endif
+        return TRUE;
+    }
+
+#else
+    const scpi_command_t * cmd = &context->cmdlist[entry->cmd];
+
+    if (matchCommand(cmd->pattern, header, len, NULL, 0, 0)) {
+        context->param_list.cmd = cmd;
+        return TRUE;
+    }
+#endif
+
+    return FALSE;
+}
+
+/**
+ * Search matching pattern using command index. Only commands with the same
+ * leading mnemonic and commands with too short mnemonics are checked,
+ * in the command list order.
+ * @param context
+ * @result TRUE if context->paramlist is filled with correct values
+ */
+static scpi_bool_t findCommandHeaderIndexed(scpi_t * context, const char * header, int len) {
+    const scpi_cmd_index_t * index = context->cmd_index;
+    uint16_t key = cmdIndexHeaderKey(header, len);
+
+    /* entries with SCPI_CMD_INDEX_KEY_ANY are at the beginning */
+    uint16_t any = 0;
+    uint16_t any_end = cmdIndexLowerBound(index, SCPI_CMD_INDEX_KEY_ANY + 1);
+
+    uint16_t i = any_end;
+    uint16_t i_end = any_end;
+
+    if (key != SCPI_CMD_INDEX_KEY_ANY) {
+        i = cmdIndexLowerBound(index, key);
+        i_end = key == UINT16_MAX ? index->count : cmdIndexLowerBound(index, key + 1);
+    }
+
+    while (any < any_end || i < i_end) {
+        const scpi_cmd_index_entry_t * entry;
+        if (i >= i_end || (any < any_end && index->entries[any].cmd < index->entries[i].cmd)) {
+            entry = &index->entries[any++];
+        } else {
+            entry = &index->entries[i++];
+        }
+
+        if (matchIndexEntry(context, entry, header, len)) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+#endif /* USE_COMMAND_INDEX */
+
 /**
  * Cycle all patterns and search matching pattern. Execute command callback.
  * @param context
@@ -169,6 +501,12 @@ static scpi_bool_t processCommand(scpi_t * context) {
  */
 static scpi_bool_t findCommandHeader(scpi_t * context, const char * header, int len) {
     int32_t i;
+
+#if USE_COMMAND_INDEX
+    if (context->cmd_index) {
+        return findCommandHeaderIndexed(context, header, len);
+    }
+#endif
     
 #if USE_64K_PROGMEM_FOR_CMD_LIST
     PGM_P pattern;
@@ -224,34 +562,45 @@ static scpi_bool_t findCommandHeader(scpi_t * context, const char * header, int
 }
 
 /**
- * Parse one command line
+ * Check if execution of the following program message units must be postponed
  * @param context
- * @param data - complete command line
- * @param len - command line length
- * @return FALSE if there was some error during evaluation of commands
+ * @return TRUE if the hold callback of the interface returns TRUE
  */
-scpi_bool_t SCPI_Parse(scpi_t * context, char * data, int len) {
-    scpi_bool_t result = TRUE;
-    scpi_parser_state_t * state;
-    int r;
-    scpi_token_t cmd_prev = {SCPI_TOKEN_UNKNOWN, NULL, 0};
-
-    if (context == NULL) {
-        return FALSE;
-    }
+static scpi_bool_t isInputHeld(scpi_t * context) {
+    return context->interface && context->interface->hold && context->interface->hold(context);
+}
 
-    state = &context->parser_state;
-    context->output_count = 0;
+/**
+ * Parse program message units
+ * @param context
+ * @param data - program message units
+ * @param len - length of data
+ * @param cmd_prev - header of the previous command, used to compose compound commands
+ * @param complete - if FALSE, stop at the first program message unit which is
+ *                   not terminated by semicolon
+ * @param can_hold - if TRUE, stop after the program message unit which made
+ *                   the hold callback of the interface return TRUE
+ * @param result - set to FALSE if there was some error during evaluation of commands
+ * @return number of characters parsed
+ */
+static int parseProgramMessageUnits(scpi_t * context, char * data, int len, scpi_token_t * cmd_prev, scpi_bool_t complete, scpi_bool_t can_hold, scpi_bool_t * result) {
+    scpi_parser_state_t * state = &context->parser_state;
+    int parsed = 0;
+    int r;
 
-    while (1) {
+    while (len > 0) {
         r = scpiParser_detectProgramMessageUnit(state, data, len);
 
+        if (!complete && state->termination != SCPI_MESSAGE_TERMINATION_SEMICOLON) {
+            break;
+        }
+
         if (state->programHeader.type == SCPI_TOKEN_INVALID) {
             SCPI_ErrorPush(context, SCPI_ERROR_INVALID_CHARACTER);
-            result = FALSE;
+            *result = FALSE;
         } else if (state->programHeader.len > 0) {
 
-            composeCompoundCommand(&cmd_prev, &state->programHeader);
+            composeCompoundCommand(cmd_prev, &state->programHeader);
 
             if (findCommandHeader(context, state->programHeader.ptr, state->programHeader.len)) {
 
@@ -262,23 +611,51 @@ scpi_bool_t SCPI_Parse(scpi_t * context, char * data, int len) {
                 context->param_list.cmd_raw.position = 0;
                 context->param_list.cmd_raw.length = state->programHeader.len;
 
-                result &= processCommand(context);
-                cmd_prev = state->programHeader;
+                *result &= processCommand(context);
+                *cmd_prev = state->programHeader;
             } else {
                 SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
-                result = FALSE;
+                *result = FALSE;
             }
         }
 
+        parsed += r;
+
+        if (can_hold && isInputHeld(context)) {
+            context->buffer.held = TRUE;
+            break;
+        }
+
         if (r < len) {
             data += r;
             len -= r;
         } else {
             break;
         }
+    }
+
+    return parsed;
+}
+
+/**
+ * Parse one command line
+ * @param context
+ * @param data - complete command line
+ * @param len - command line length
+ * @return FALSE if there was some error during evaluation of commands
+ */
+scpi_bool_t SCPI_Parse(scpi_t * context, char * data, int len) {
+    scpi_bool_t result = TRUE;
+    scpi_token_t cmd_prev = {SCPI_TOKEN_UNKNOWN, NULL, 0};
 
+    if (context == NULL) {
+        return FALSE;
     }
 
+    context->output_count = 0;
+
+    parseProgramMessageUnits(context, data, len, &cmd_prev, TRUE, FALSE, &result);
+
     /* conditionaly write new line */
     writeNewLine(context);
 
@@ -318,10 +695,185 @@ void SCPI_Init(scpi_t * context,
 #endif
 }
 
+/**
+ * Keep the rest of the input buffer after the parsed program message units,
+ * together with the header path of the last command, needed by the following
+ * compound commands (see composeCompoundCommand).
+ * @param context
+ * @param cmd_prev - header of the last parsed command
+ * @param tail - position of the first not parsed character in the buffer
+ */
+static void keepInputBuffer(scpi_t * context, const scpi_token_t * cmd_prev, size_t tail) {
+    char * data = context->buffer.data;
+    size_t i;
+
+    context->buffer.partial = TRUE;
+
+    /* keep header path of the last command */
+    i = 0;
+    if ((cmd_prev->ptr != NULL) && (cmd_prev->len > 0) && (cmd_prev->ptr[0] != '*')) {
+        for (i = cmd_prev->len; i > 0; i--) {
+            if (cmd_prev->ptr[i - 1] == ':') {
+                break;
+            }
+        }
+    }
+    memmove(data, cmd_prev->ptr, i);
+
+    memmove(data + i, data + tail, context->buffer.position - tail);
+    context->buffer.position = i + context->buffer.position - tail;
+    context->buffer.data[context->buffer.position] = 0;
+    context->buffer.prefix = i;
+}
+
+/**
+ * Parse the rest of the program message from the input buffer and remove it
+ * from the buffer. Previous program message units of the same message could
+ * be already executed by flushInputBuffer. If the input gets held, only the
+ * executed program message units are removed.
+ * @param context
+ * @param len - length of the program message in the input buffer
+ * @return FALSE if there was some error during evaluation of commands
+ */
+static scpi_bool_t parseInputBuffer(scpi_t * context, int len) {
+    scpi_bool_t result = TRUE;
+    size_t prefix = context->buffer.prefix;
+    scpi_token_t cmd_prev = {SCPI_TOKEN_UNKNOWN, context->buffer.data, prefix};
+    int parsed;
+
+    if (!context->buffer.partial) {
+        context->output_count = 0;
+    }
+
+    parsed = parseProgramMessageUnits(context, context->buffer.data + prefix, len - prefix, &cmd_prev, TRUE, TRUE, &result);
+
+    if (context->buffer.held && (int)(prefix + parsed) < len) {
+        keepInputBuffer(context, &cmd_prev, prefix + parsed);
+        return result;
+    }
+
+    /* conditionaly write new line */
+    writeNewLine(context);
+
+    memmove(context->buffer.data, context->buffer.data + len, context->buffer.position - len);
+    context->buffer.position -= len;
+    context->buffer.data[context->buffer.position] = 0;
+    context->buffer.prefix = 0;
+    context->buffer.partial = FALSE;
+
+    return result;
+}
+
+/**
+ * Execute complete program message units (terminated by semicolon) from the
+ * input buffer before the whole program message is received. Only the
+ * incomplete program message unit is kept in the buffer, together with
+ * the header path of the last command.
+ * @param context
+ * @param result - set to FALSE if there was some error during evaluation of commands
+ * @return FALSE if there was no complete program message unit in the buffer
+ */
+static scpi_bool_t flushInputBuffer(scpi_t * context, scpi_bool_t * result) {
+    size_t prefix = context->buffer.prefix;
+    scpi_token_t cmd_prev = {SCPI_TOKEN_UNKNOWN, context->buffer.data, prefix};
+    int parsed;
+
+    if (!context->buffer.partial) {
+        context->output_count = 0;
+    }
+
+    parsed = parseProgramMessageUnits(context, context->buffer.data + prefix, context->buffer.position - prefix, &cmd_prev, FALSE, TRUE, result);
+    if (parsed == 0) {
+        return FALSE;
+    }
+
+    keepInputBuffer(context, &cmd_prev, prefix + parsed);
+
+    return TRUE;
+}
+
+/**
+ * Execute complete program messages and complete program message units
+ * from the input buffer, until the input gets held.
+ * @param context
+ * @param nl - buffer can contain complete program message
+ * @param semicolon - buffer can contain complete program message unit
+ * @param result - set to FALSE if there was some error during evaluation of commands
+ */
+static void processInputBuffer(scpi_t * context, scpi_bool_t nl, scpi_bool_t semicolon, scpi_bool_t * result) {
+    size_t totcmdlen;
+    int cmdlen;
+
+    if (nl) {
+        totcmdlen = context->buffer.prefix;
+        while (!context->buffer.held) {
+            cmdlen = scpiParser_detectProgramMessageUnit(&context->parser_state, context->buffer.data + totcmdlen, context->buffer.position - totcmdlen);
+            totcmdlen += cmdlen;
+
+            if (context->parser_state.termination == SCPI_MESSAGE_TERMINATION_NL) {
+                *result &= parseInputBuffer(context, totcmdlen);
+                totcmdlen = 0;
+            } else {
+                if (context->parser_state.programHeader.type == SCPI_TOKEN_UNKNOWN) break;
+                if (totcmdlen >= context->buffer.position) break;
+            }
+        }
+    }
+
+    /* execute complete program message units without waiting for the new line */
+    if (semicolon && !context->buffer.held) {
+        flushInputBuffer(context, result);
+    }
+}
+
+/**
+ * Continue with the input kept in the buffer if the input is held and
+ * the hold callback of the interface doesn't return TRUE any more.
+ * @param context
+ * @param result - set to FALSE if there was some error during evaluation of commands
+ */
+static void resumeInput(scpi_t * context, scpi_bool_t * result) {
+    if (context->buffer.held && !isInputHeld(context)) {
+        context->buffer.held = FALSE;
+        processInputBuffer(context, TRUE, TRUE, result);
+    }
+}
+
+/**
+ * Find the first new line character, either LF or CR, the same as accepted
+ * by the lexer as program message terminator.
+ * @param data
+ * @param len
+ * @return pointer to the new line character or NULL if not found
+ */
+static const char * findNewLine(const char * data, int len) {
+    int i;
+    for (i = 0; i < len; i++) {
+        if (data[i] == '\n' || data[i] == '\r') {
+            return data + i;
+        }
+    }
+    return NULL;
+}
+
 /**
  * Interface to the application. Adds data to system buffer and try to search
  * command line termination. If the termination is found or if len=0, command
- * parser is called.
+ * parser is called. Data can be received in blocks of any size, block is
+ * copied in parts which fit into the buffer and only the incomplete program
+ * message is kept in the buffer.
+ *
+ * Program message units terminated by semicolon are executed as soon as they
+ * are received, so program message can be longer than the input buffer.
+ * Only if single program message unit doesn't fit into the buffer, the rest
+ * of the program message is discarded and SCPI_ERROR_INPUT_BUFFER_OVERRUN
+ * is reported.
+ *
+ * If the hold callback of the interface returns TRUE after some program
+ * message unit, the following units are not executed, but kept in the buffer
+ * (together with the rest of the data) until SCPI_InputResume is called
+ * when the callback returns FALSE. Data which doesn't fit into the buffer
+ * while the input is held is discarded as on buffer overrun.
  *
  * @param context
  * @param data - data to process
@@ -330,48 +882,102 @@ void SCPI_Init(scpi_t * context,
  */
 scpi_bool_t SCPI_Input(scpi_t * context, const char * data, int len) {
     scpi_bool_t result = TRUE;
-    size_t totcmdlen = 0;
-    int cmdlen = 0;
+
+    resumeInput(context, &result);
 
     if (len == 0) {
+        if (context->buffer.held) {
+            return result;
+        }
         context->buffer.data[context->buffer.position] = 0;
-        result = SCPI_Parse(context, context->buffer.data, context->buffer.position);
+        if (context->buffer.discard) {
+            if (context->buffer.partial) {
+                writeNewLine(context);
+            }
+            context->buffer.discard = FALSE;
+        } else {
+            result &= parseInputBuffer(context, context->buffer.position);
+            if (context->buffer.held) {
+                return result;
+            }
+        }
         context->buffer.position = 0;
-    } else {
+        context->buffer.prefix = 0;
+        context->buffer.partial = FALSE;
+        return result;
+    }
+
+    while (len > 0) {
         int buffer_free;
+        int chunk_len;
 
-        buffer_free = context->buffer.length - context->buffer.position;
-        if (len > (buffer_free - 1)) {
+        if (context->buffer.discard) {
+            /* skip the rest of program message after buffer overrun */
+            const char * nl = findNewLine(data, len);
+            if (nl == NULL) {
+                break;
+            }
+            len -= nl + 1 - data;
+            data = nl + 1;
+
+            if (context->buffer.partial) {
+                writeNewLine(context);
+            }
+            context->buffer.discard = FALSE;
+            context->buffer.partial = FALSE;
+            continue;
+        }
+
+        buffer_free = context->buffer.length - context->buffer.position - 1;
+        if ((buffer_free <= 0) && !context->buffer.held && flushInputBuffer(context, &result)) {
+            buffer_free = context->buffer.length - context->buffer.position - 1;
+        }
+
+        if (buffer_free <= 0) {
             /* Input buffer overrun - invalidate buffer */
             context->buffer.position = 0;
+            context->buffer.prefix = 0;
             context->buffer.data[context->buffer.position] = 0;
+            context->buffer.discard = TRUE;
             SCPI_ErrorPush(context, SCPI_ERROR_INPUT_BUFFER_OVERRUN);
-            return FALSE;
+            result = FALSE;
+            continue;
         }
-        memcpy(&context->buffer.data[context->buffer.position], data, len);
-        context->buffer.position += len;
-        context->buffer.data[context->buffer.position] = 0;
-
 
-        while (1) {
-            cmdlen = scpiParser_detectProgramMessageUnit(&context->parser_state, context->buffer.data + totcmdlen, context->buffer.position - totcmdlen);
-            totcmdlen += cmdlen;
+        chunk_len = len < buffer_free ? len : buffer_free;
+        memcpy(&context->buffer.data[context->buffer.position], data, chunk_len);
+        context->buffer.position += chunk_len;
+        context->buffer.data[context->buffer.position] = 0;
 
-            if (context->parser_state.termination == SCPI_MESSAGE_TERMINATION_NL) {
-                result = SCPI_Parse(context, context->buffer.data, totcmdlen);
-                memmove(context->buffer.data, context->buffer.data + totcmdlen, context->buffer.position - totcmdlen);
-                context->buffer.position -= totcmdlen;
-                totcmdlen = 0;
-            } else {
-                if (context->parser_state.programHeader.type == SCPI_TOKEN_UNKNOWN) break;
-                if (totcmdlen >= context->buffer.position) break;
-            }
+        /* program message can be completed only by new line in received data,
+           input kept while held is processed by resumeInput */
+        if (!context->buffer.held) {
+            processInputBuffer(context,
+                findNewLine(data, chunk_len) != NULL,
+                memchr(data, ';', chunk_len) != NULL,
+                &result);
         }
+
+        data += chunk_len;
+        len -= chunk_len;
     }
 
     return result;
 }
 
+/**
+ * Continue with the program message units kept in the input buffer, after
+ * the input was held (see SCPI_Input). Does nothing if the input is not held
+ * or the hold callback of the interface still returns TRUE.
+ * @param context
+ * @return FALSE if there was some error during evaluation of commands
+ */
+scpi_bool_t SCPI_InputResume(scpi_t * context) {
+    scpi_bool_t result = TRUE;
+    resumeInput(context, &result);
+    return result;
+}
+
 /* writing results */
 
 /**
@@ -567,7 +1173,7 @@ size_t SCPI_ResultArbitraryBlockHeader(scpi_t * context, size_t len) {
     block_header[1] = (char) (header_len + '0');
 
     context->arbitrary_reminding = len;
-    return writeData(context, block_header, header_len + 2);
+    return writeDelimiter(context) + writeData(context, block_header, header_len + 2);
 }
 
 /**
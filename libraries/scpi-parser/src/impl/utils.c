@@ -45,7 +45,6 @@
 #include "utils_private.h"
 #include "scpi/utils.h"
 
-static size_t patternSeparatorShortPos(const char * pattern, size_t len);
 static size_t patternSeparatorPos(const char * pattern, size_t len);
 static size_t cmdSeparatorPos(const char * cmd, size_t len);
 
@@ -426,7 +425,7 @@ size_t skipWhitespace(const char * cmd, size_t len) {
  * @param len - max search length
  * @return position of separator or len
  */
-static size_t patternSeparatorShortPos(const char * pattern, size_t len) {
+size_t patternSeparatorShortPos(const char * pattern, size_t len) {
     size_t i;
     for (i = 0; (i < len) && pattern[i]; i++) {
         if (islower((unsigned char) pattern[i])) {
@@ -104,6 +104,20 @@ extern "C" {
 #define USE_FULL_PROGMEM_FOR_CMD_LIST 0
 #endif
 
+/**
+ * Detect, if command index should be used to speed up command header lookup
+ */
+#ifndef USE_COMMAND_INDEX
+#define USE_COMMAND_INDEX 1
+#endif
+
+/**
+ * Number of leading mnemonic characters used as command index key
+ */
+#ifndef SCPI_CMD_INDEX_KEY_LEN
+#define SCPI_CMD_INDEX_KEY_LEN 3
+#endif
+
 #ifndef USE_DEPRECATED_FUNCTIONS
 #define USE_DEPRECATED_FUNCTIONS 1
 #endif
@@ -51,7 +51,14 @@ extern "C" {
             char * input_buffer, size_t input_buffer_length, 
             int16_t * error_queue_data, int16_t error_queue_size);
 
+#if USE_COMMAND_INDEX
+    scpi_bool_t SCPI_InitCommandIndex(scpi_t * context, scpi_cmd_index_t * index,
+            scpi_cmd_index_entry_t * entries, size_t entries_size);
+    void SCPI_SetCommandIndex(scpi_t * context, const scpi_cmd_index_t * index);
+#endif
+
     scpi_bool_t SCPI_Input(scpi_t * context, const char * data, int len);
+    scpi_bool_t SCPI_InputResume(scpi_t * context);
     scpi_bool_t SCPI_Parse(scpi_t * context, char * data, int len);
 
     size_t SCPI_ResultCharacters(scpi_t * context, const char * data, size_t len);
@@ -127,6 +127,10 @@ extern "C" {
         size_t length;
         size_t position;
         char * data;
+        size_t prefix;
+        scpi_bool_t partial;
+        scpi_bool_t discard;
+        scpi_bool_t held;
     };
     typedef struct _scpi_buffer_t scpi_buffer_t;
 
@@ -140,6 +144,7 @@ extern "C" {
     typedef size_t(*scpi_write_t)(scpi_t * context, const char * data, size_t len);
     typedef scpi_result_t(*scpi_write_control_t)(scpi_t * context, scpi_ctrl_name_t ctrl, scpi_reg_val_t val);
     typedef int (*scpi_error_callback_t)(scpi_t * context, int_fast16_t error);
+    typedef scpi_bool_t(*scpi_hold_callback_t)(scpi_t * context);
 
     /* scpi lexer */
     enum _scpi_token_type_t {
@@ -263,6 +268,23 @@ extern "C" {
 #endif /* USE_COMMAND_TAGS */
     };
 
+#if USE_COMMAND_INDEX
+    struct _scpi_cmd_index_entry_t {
+        uint16_t key;
+        uint16_t cmd;
+#if USE_FULL_PROGMEM_FOR_CMD_LIST
+        uint16_t pattern_offset;
+#endif
+    };
+    typedef struct _scpi_cmd_index_entry_t scpi_cmd_index_entry_t;
+
+    struct _scpi_cmd_index_t {
+        scpi_cmd_index_entry_t * entries;
+        uint16_t count;
+    };
+    typedef struct _scpi_cmd_index_t scpi_cmd_index_t;
+#endif /* USE_COMMAND_INDEX */
+
     struct _scpi_param_list_t {
         const scpi_command_t * cmd;
         lex_state_t lex_state;
@@ -300,6 +322,7 @@ extern "C" {
         scpi_write_control_t control;
         scpi_command_callback_t flush;
         scpi_command_callback_t reset;
+        scpi_hold_callback_t hold;
     };
 
     struct _scpi_t {
@@ -308,6 +331,9 @@ extern "C" {
         uint_farptr_t cmdpatterns;
 #else        
         const scpi_command_t * cmdlist;
+#endif
+#if USE_COMMAND_INDEX
+        const scpi_cmd_index_t * cmd_index;
 #endif
         scpi_buffer_t buffer;
         scpi_param_list_t param_list;
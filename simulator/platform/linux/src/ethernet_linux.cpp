@@ -15,14 +15,16 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-
 #include "psu.h"
 #include "ethernet_platform.h"
+#include "ethernet_linux.h"
 
 #include <errno.h>
 #include <unistd.h>
+#include <poll.h>
 #include <sys/types.h> 
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <netinet/in.h>
 #include <fcntl.h>
 
@@ -30,8 +32,29 @@ namespace eez {
 namespace psu {
 namespace ethernet_platform {
 
+/// Size of the buffer for data received from one client.
+#define CLIENT_BUFFER_SIZE 4096
+
+/// How long to wait for the client to accept more data, before the write is given up.
+#define WRITE_TIMEOUT_MS 1000
+
+/// epoll event data of the listen socket, client events have client id.
+#define LISTEN_EVENT UIP_CONF_MAX_CONNECTIONS
+
+struct Client {
+    int socket;
+    bool remote_closed;
+
+    // ring buffer with received data
+    char buffer[CLIENT_BUFFER_SIZE];
+    int head;
+    int count;
+};
+
 static int listen_socket = -1;
-static int client_socket = -1;
+static int epoll_fd = -1;
+static bool accept_pending = false;
+static Client clients[UIP_CONF_MAX_CONNECTIONS];
 
 bool enable_non_blocking(int fd) {
     int flags = fcntl(fd, F_GETFL, 0);
@@ -45,7 +68,32 @@ bool enable_non_blocking(int fd) {
     return true;
 }
 
+static bool epoll_add(int fd, uint32_t data) {
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u32 = data;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+static void close_client(int client) {
+    close(clients[client].socket);
+    clients[client].socket = -1;
+    clients[client].remote_closed = false;
+    clients[client].head = 0;
+    clients[client].count = 0;
+}
+
 bool bind(int port) {
+    for (int i = 0; i < UIP_CONF_MAX_CONNECTIONS; ++i) {
+        clients[i].socket = -1;
+    }
+
+    epoll_fd = epoll_create1(0);
+    if (epoll_fd < 0) {
+        DebugTrace("EHTERNET: epoll_create failed with error %d", errno);
+        return false;
+    }
+
     sockaddr_in serv_addr;
     listen_socket = socket(AF_INET, SOCK_STREAM, 0);
     if (listen_socket < 0) {
@@ -78,100 +126,202 @@ bool bind(int port) {
         return false;
     }
 
+    if (!epoll_add(listen_socket, LISTEN_EVENT)) {
+        DebugTrace("EHTERNET: epoll_ctl on listen socket failed with error %d", errno);
+        close(listen_socket);
+        listen_socket = -1;
+        return false;
+    }
+
     return true;
 }
 
-bool client_available() {
-    if (connected()) return true;
+int get_event_fd() {
+    return listen_socket != -1 ? epoll_fd : -1;
+}
 
-    if (listen_socket == -1) {
-        return 0;
+static void receive(int client) {
+    Client &c = clients[client];
+
+    while (c.count < CLIENT_BUFFER_SIZE) {
+        // read into the free space up to the end of the ring buffer
+        int tail = (c.head + c.count) % CLIENT_BUFFER_SIZE;
+        int size = tail >= c.head ? CLIENT_BUFFER_SIZE - tail : c.head - tail;
+        if (size > CLIENT_BUFFER_SIZE - c.count) {
+            size = CLIENT_BUFFER_SIZE - c.count;
+        }
+
+        int n = ::read(c.socket, c.buffer + tail, size);
+        if (n > 0) {
+            c.count += n;
+            continue;
+        }
+
+        if (n < 0 && (errno == EWOULDBLOCK || errno == EINTR)) {
+            return;
+        }
+
+        // closed by the remote side or error, keep received data until it is read
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c.socket, 0);
+        c.remote_closed = true;
+        return;
+    }
+
+    // buffer is full, level triggered epoll will report the rest of the data
+}
+
+void process_events() {
+    epoll_event events[UIP_CONF_MAX_CONNECTIONS + 1];
+    int n = epoll_wait(epoll_fd, events, UIP_CONF_MAX_CONNECTIONS + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        uint32_t data = events[i].data.u32;
+        if (data == LISTEN_EVENT) {
+            accept_pending = true;
+        } else if (clients[data].socket != -1 && !clients[data].remote_closed) {
+            receive(data);
+        }
+    }
+}
+
+int accept() {
+    if (listen_socket == -1 || !accept_pending) {
+        return -1;
     }
 
     sockaddr_in cli_addr;
     socklen_t clilen = sizeof(cli_addr);
-    client_socket = accept(listen_socket, (sockaddr *)&cli_addr, &clilen);
+    int client_socket = ::accept(listen_socket, (sockaddr *)&cli_addr, &clilen);
     if (client_socket < 0) {
         if (errno == EWOULDBLOCK) {
-            return false;
+            accept_pending = false;
+            return -1;
         }
 
         DebugTrace("EHTERNET: accept failed with error %d", errno);
         close(listen_socket);
         listen_socket = -1;
-        return false;
+        return -1;
+    }
+
+    int client;
+    for (client = 0; client < UIP_CONF_MAX_CONNECTIONS && clients[client].socket != -1; ++client) {
+    }
+
+    if (client == UIP_CONF_MAX_CONNECTIONS) {
+        // no free connection, same as UIPEthernet refuse it
+        DebugTrace("EHTERNET: too many connections");
+        close(client_socket);
+        return -1;
     }
 
     if (!enable_non_blocking(client_socket)) {
         DebugTrace("EHTERNET: ioctl on client socket failed with error %d", errno);
         close(client_socket);
-        listen_socket = -1;
+        return -1;
+    }
+
+    if (!epoll_add(client_socket, client)) {
+        DebugTrace("EHTERNET: epoll_ctl on client socket failed with error %d", errno);
+        close(client_socket);
+        return -1;
+    }
+
+    clients[client].socket = client_socket;
+    clients[client].remote_closed = false;
+    clients[client].head = 0;
+    clients[client].count = 0;
+
+    // data could be received before the socket was added to epoll
+    receive(client);
+
+    return client;
+}
+
+bool connected(int client) {
+    if (clients[client].socket == -1) {
+        return false;
+    }
+
+    if (clients[client].remote_closed && clients[client].count == 0) {
+        close_client(client);
         return false;
     }
 
     return true;
 }
 
-bool connected() {
-    return client_socket != -1;
+int available(int client) {
+    return connected(client) ? clients[client].count : 0;
 }
 
-int available() {
-    if (client_socket == -1) return 0;
+int read(int client, char *buffer, int buffer_size) {
+    Client &c = clients[client];
 
-    char x;
-    int iResult = ::recv(client_socket, &x, 1, MSG_PEEK);
-    if (iResult > 0) {
-        return iResult;
-    }
+    int n = 0;
+    while (n < buffer_size && c.count > 0) {
+        int size = CLIENT_BUFFER_SIZE - c.head;
+        if (size > c.count) {
+            size = c.count;
+        }
+        if (size > buffer_size - n) {
+            size = buffer_size - n;
+        }
 
-    if (iResult < 0 && errno == EWOULDBLOCK) {
-        return 0;
+        memcpy(buffer + n, c.buffer + c.head, size);
+        n += size;
+        c.head = (c.head + size) % CLIENT_BUFFER_SIZE;
+        c.count -= size;
     }
 
-    stop();
+    if (c.count == 0) {
+        c.head = 0;
+    }
 
-    return 0;
+    return n;
 }
 
-int read(char *buffer, int buffer_size) {
-    int n = ::read(client_socket, buffer, buffer_size);
-    if (n > 0) {
-        return n;
-    }
-
-    if (n < 0 && errno == EWOULDBLOCK) {
+int write(int client, const char *buffer, int buffer_size) {
+    if (clients[client].socket == -1) {
         return 0;
     }
 
-    stop();
+    int written = 0;
+    while (written < buffer_size) {
+        int n = ::send(clients[client].socket, buffer + written, buffer_size - written, MSG_NOSIGNAL);
+        if (n > 0) {
+            written += n;
+            continue;
+        }
 
-    return 0;
-}
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
 
-int write(const char *buffer, int buffer_size) {
-    if (client_socket != -1) {
-        int n = ::write(client_socket, buffer, buffer_size);
-        if (n < 0) {
-            close(client_socket);
-            client_socket = -1;
-            return 0;
+        if (n < 0 && errno == EWOULDBLOCK) {
+            // client doesn't read fast enough, wait until it does
+            pollfd fd = { clients[client].socket, POLLOUT, 0 };
+            if (poll(&fd, 1, WRITE_TIMEOUT_MS) > 0) {
+                continue;
+            }
         }
-        return n;
+
+        close_client(client);
+        break;
     }
 
-    return 0;
+    return written;
 }
 
-void stop() {    
-    int result = shutdown(client_socket, SHUT_WR);
+void stop(int client) {
+    if (clients[client].socket == -1) return;
+
+    int result = shutdown(clients[client].socket, SHUT_WR);
     if (result < 0) {
         DebugTrace("ETHERNET shutdown failed with error %d\n", errno);
     }
-    close(client_socket);
-    client_socket = -1;
+    close_client(client);
 }
 
 }
 }
-} // namespace eez::psu::ethernet_platform
+} // namespace eez::psu::ethernet_platform
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2015 Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+
+/// Lock-free single producer/single consumer byte ring.
+/// Producer and consumer work directly in the ring memory:
+/// get contiguous region, fill it (or process it) and commit.
+/// SIZE must be a power of two.
+template<size_t SIZE>
+class InputRing {
+public:
+    InputRing() : head(0), tail(0) {}
+
+    /// Producer side. Returns the size of contiguous free space at *p.
+    size_t getWriteRegion(char **p) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t t = tail.load(std::memory_order_acquire);
+        size_t space = SIZE - (h - t);
+        size_t offset = h & (SIZE - 1);
+        *p = buffer + offset;
+        return space < SIZE - offset ? space : SIZE - offset;
+    }
+
+    /// Producer side. Publish n bytes written to the write region.
+    void commitWrite(size_t n) {
+        head.store(head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    /// Consumer side. Returns the size of contiguous data available at *p.
+    size_t getReadRegion(const char **p) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+        size_t count = h - t;
+        size_t offset = t & (SIZE - 1);
+        *p = buffer + offset;
+        return count < SIZE - offset ? count : SIZE - offset;
+    }
+
+    /// Consumer side. Release n bytes of the read region.
+    void commitRead(size_t n) {
+        tail.store(tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+private:
+    static_assert((SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+    char buffer[SIZE];
+    // head and tail are free running counters, written only by the producer
+    // and the consumer respectively
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+};
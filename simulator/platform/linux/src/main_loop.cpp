@@ -18,64 +18,230 @@
 
 #include "psu.h"
 #include "serial_psu.h"
+#include "ethernet.h"
 #include "main_loop.h"
+#include "ethernet_linux.h"
 
 #include <errno.h>
-#include "thread_queue.h"
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "input_ring.h"
 
 using namespace eez::psu;
 
-#define NEW_INPUT_MESSAGE 1
-#define QUIT_MESSAGE      2
+#define INPUT_EVENT    1
+#define ETHERNET_EVENT 2
 
-threadqueue queue;
+/// Max. number of stdin bytes given to the SCPI parser between two
+/// checks of the tick deadline.
+#define INPUT_BUDGET 4096
+
+/// stdin data, input thread is producer and main loop is consumer
+static InputRing<65536> input_ring;
+static std::atomic<bool> input_eof(false);
+
+/// Signaled by the input thread when new data is in the ring.
+static int input_event_fd = -1;
+
+/// Signaled by the main loop when space is freed in the full ring.
+static int space_event_fd = -1;
+static std::atomic<bool> input_thread_waiting(false);
+
+static void signal_event(int fd) {
+    uint64_t value = 1;
+    ::write(fd, &value, sizeof(value));
+}
+
+static void wait_event(int fd) {
+    uint64_t value;
+    ::read(fd, &value, sizeof(value));
+}
 
 void *input_thread(void *) {
 	while (1) {
-		int ch = getchar();
-		if (ch == EOF) break;
+		char *p;
+		size_t space = input_ring.getWriteRegion(&p);
+		if (space == 0) {
+			// ring is full, wait until main loop consumes something
+			input_thread_waiting = true;
+			// flag store must be visible before the ring is checked again,
+			// pairs with the fence in process_input
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			space = input_ring.getWriteRegion(&p);
+			if (space == 0) {
+				wait_event(space_event_fd);
+			}
+			input_thread_waiting = false;
+			continue;
+		}
+
+		ssize_t n = ::read(STDIN_FILENO, p, space);
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) break;
 
-		thread_queue_add(&queue, new char(ch), NEW_INPUT_MESSAGE);
+		input_ring.commitWrite(n);
+		signal_event(input_event_fd);
 	}
 
-	thread_queue_add(&queue, 0, QUIT_MESSAGE);
+	input_eof = true;
+	signal_event(input_event_fd);
 
 	return 0;
 }
 
+static uint64_t get_time_ms() {
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static bool add_event(int epoll_fd, int fd, uint32_t data) {
+	epoll_event event;
+	event.events = EPOLLIN;
+	event.data.u32 = data;
+	return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+/// Input is queued in the ring until power up or virtual time step is finished.
+static bool is_input_blocked() {
+	return isPowerUpInProgress() || simulator::isTimeStepPending();
+}
+
+/// Give up to INPUT_BUDGET bytes from the input ring to the SCPI parser.
+/// \returns false if the input is closed and all the data is processed.
+static bool process_input(bool &input_pending) {
+	// eof must be checked before draining the ring, so no data is lost
+	bool eof = input_eof;
+
+	size_t budget = INPUT_BUDGET;
+	while (budget > 0) {
+		const char *p;
+		size_t n = input_ring.getReadRegion(&p);
+		if (n == 0) break;
+		if (n > budget) n = budget;
+
+		// pass one line at a time, so lines after the command
+		// which started power up or time step stay queued until it is finished
+		const char *eol = (const char *)memchr(p, '\n', n);
+		if (eol) {
+			n = eol - p + 1;
+		}
+
+		scpi::input(serial::scpi_context, p, n);
+		input_ring.commitRead(n);
+		budget -= n;
+
+		// freed space must be visible before the flag is checked,
+		// otherwise both threads could miss each other
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (input_thread_waiting) {
+			signal_event(space_event_fd);
+		}
+
+		if (is_input_blocked()) {
+			break;
+		}
+	}
+
+	if (budget == 0 || is_input_blocked()) {
+		input_pending = true;
+		return true;
+	}
+
+	input_pending = false;
+	return !eof;
+}
 
 int main_loop() {
-	timespec timeout = { 0, TICK_TIMEOUT * 1000 * 1000 };
+	input_event_fd = eventfd(0, EFD_NONBLOCK);
+	if (input_event_fd < 0) return -1;
+
+	space_event_fd = eventfd(0, 0);
+	if (space_event_fd < 0) return -1;
 
-	if (thread_queue_init(&queue) != 0) return -1;
+	int epoll_fd = epoll_create1(0);
+	if (epoll_fd < 0) return -1;
+
+	if (!add_event(epoll_fd, input_event_fd, INPUT_EVENT)) return -1;
+
+	// wake up as soon as some ethernet client sends something
+	int ethernet_fd = ethernet_platform::get_event_fd();
+	if (ethernet_fd != -1 && !add_event(epoll_fd, ethernet_fd, ETHERNET_EVENT)) return -1;
 
 	pthread_t thread;
 	pthread_create(&thread, 0, input_thread, 0);
 
+	uint64_t next_tick = get_time_ms() + TICK_TIMEOUT;
+	bool input_pending = false;
+
 	while (1) {
-        threadmsg msg;
-        char *p_ch;
-        int ret;
-		switch (ret = thread_queue_get(&queue, &timeout, &msg)) {
-		case 0:
-			switch (msg.msgtype) {
-			case NEW_INPUT_MESSAGE:
-				p_ch = (char *)msg.data;
-				scpi::input(serial::scpi_context, *p_ch);
-				delete p_ch;
+		uint64_t now = get_time_ms();
+		bool input_ready = input_pending && !is_input_blocked();
+		bool virtual_time = simulator::getTimeMode() == simulator::TIME_MODE_VIRTUAL;
+		int timeout;
+		if (input_ready) {
+			timeout = 0;
+		}
+		else {
+			timeout = next_tick > now ? (int)(next_tick - now) : 0;
+			if (virtual_time) {
+				// don't wait longer than one tick, even if the clock is stopped
+				int time_wait = simulator::getTimeWait(TICK_TIMEOUT * 1000, input_pending);
+				if (time_wait >= 0 && time_wait < timeout) {
+					timeout = time_wait;
+				}
+			}
+		}
+
+		epoll_event events[2];
+		int n = epoll_wait(epoll_fd, events, 2, timeout);
+		if (n < 0 && errno != EINTR) {
+			return errno;
+		}
+
+		for (int i = 0; i < n; ++i) {
+			switch (events[i].data.u32) {
+			case INPUT_EVENT:
+				wait_event(input_event_fd);
+				input_pending = true;
 				break;
 
-			case QUIT_MESSAGE:
+			case ETHERNET_EVENT:
+				ethernet_platform::process_events();
+				ethernet::tick(micros());
+				break;
+			}
+		}
+
+		if (input_pending && !is_input_blocked()) {
+			if (!process_input(input_pending)) {
 				return 0;
 			}
-			break;
+			if (virtual_time) {
+				// all the input available is executed at the same virtual time
+				continue;
+			}
+		}
 
-		case ETIMEDOUT:
+		if (virtual_time) {
+			// input still pending here is blocked, so the clock mustn't stop
+			if (simulator::advanceTime(TICK_TIMEOUT * 1000, input_pending)) {
+				simulator::tick();
+				next_tick = get_time_ms() + TICK_TIMEOUT;
+			}
+			else if (get_time_ms() >= next_tick) {
+				// clock is stopped or behind, tick anyway without advancing it,
+				// so that ethernet clients and held input are still served
+				simulator::tick();
+				next_tick = get_time_ms() + TICK_TIMEOUT;
+			}
+		}
+		else if (get_time_ms() >= next_tick) {
 			simulator::tick();
-			break;
-
-		default:
-			return ret;
+			next_tick = get_time_ms() + TICK_TIMEOUT;
 		}
 	}
 }
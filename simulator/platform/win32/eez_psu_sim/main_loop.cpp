@@ -66,6 +66,9 @@ int main_loop() {
 			break;
 
 		case WAIT_TIMEOUT:
+            // input is processed from the tick, so tick runs even if the virtual
+            // clock is stopped and the clock advances at most one tick per tick
+            simulator::advanceTime(TICK_TIMEOUT * 1000, false);
             simulator::tick();
 			break;
 
@@ -0,0 +1,131 @@
+'''
+EEZ PSU Firmware
+Copyright (C) 2015 Envox d.o.o.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+'''
+
+# Runs SCPI script files in parallel simulator instances (see --script option
+# of the simulator). Every script runs in a new simulator process with its own
+# state directory and TCP port, so scripts don't see each other's EEPROM state.
+# Transcripts of all the scripts are merged into one JSONL file, every record
+# gets the "script" field.
+#
+# usage: python run_scripts.py [-j jobs] [--sim path] [--base-port port]
+#                              [--out results.jsonl] script.scpi...
+#
+# Exit status is 0 if all the scripts passed, 1 otherwise.
+
+import argparse
+import json
+import multiprocessing
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+default_sim = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+    'platform', 'linux', 'eez_psu_sim')
+
+parser = argparse.ArgumentParser()
+parser.add_argument('-j', '--jobs', type=int, default=multiprocessing.cpu_count())
+parser.add_argument('--sim', default=default_sim)
+parser.add_argument('--base-port', type=int, default=5100)
+parser.add_argument('--out', default='results.jsonl')
+parser.add_argument('scripts', nargs='+')
+args = parser.parse_args()
+
+work_dir = tempfile.mkdtemp(prefix='eez_psu_sim_')
+
+lock = threading.Lock()
+next_script = 0
+results = [None] * len(args.scripts)
+
+def run_script(job, index):
+    script = args.scripts[index]
+    state_dir = os.path.join(work_dir, 'state%d' % index)
+    out = os.path.join(work_dir, 'out%d.jsonl' % index)
+
+    start = time.time()
+    process = subprocess.run([args.sim,
+        '--state-dir', state_dir,
+        '--port', str(args.base_port + job),
+        '--script', script,
+        '--out', out],
+        stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    elapsed = time.time() - start
+
+    records = []
+    if os.path.exists(out):
+        with open(out, 'rb') as f:
+            for line in f:
+                record = json.loads(line.decode('utf-8', errors='replace'))
+                record['script'] = script
+                records.append(record)
+
+    results[index] = (process.returncode, elapsed, records, process.stderr.decode(errors='replace'))
+
+def run_script_safe(job, index):
+    # any failure is reported as failed script, instead of killing the worker
+    try:
+        run_script(job, index)
+    except Exception as e:
+        results[index] = (None, 0.0, [], '%s: %s\n' % (type(e).__name__, e))
+
+def worker(job):
+    global next_script
+    while True:
+        with lock:
+            index = next_script
+            next_script += 1
+        if index >= len(args.scripts):
+            break
+        run_script_safe(job, index)
+
+start = time.time()
+threads = [threading.Thread(target=worker, args=(i,)) for i in range(max(1, args.jobs))]
+for thread in threads:
+    thread.start()
+for thread in threads:
+    thread.join()
+elapsed = time.time() - start
+
+shutil.rmtree(work_dir, ignore_errors=True)
+
+num_failed = 0
+num_commands = 0
+with open(args.out, 'w') as f:
+    for script, (returncode, script_elapsed, records, stderr) in zip(args.scripts, results):
+        for record in records:
+            f.write(json.dumps(record) + '\n')
+        num_commands += len(records)
+
+        if returncode == 0:
+            status = 'passed'
+        elif returncode is None:
+            num_failed += 1
+            status = 'FAILED (exception)'
+        else:
+            num_failed += 1
+            status = 'FAILED (%d)' % returncode
+        print('%s: %s, %d commands, %.3f s' % (script, status, len(records), script_elapsed))
+        if returncode not in (0, 1):
+            sys.stdout.write(stderr)
+
+print('%d scripts, %d failed, %d commands in %.3f s' % (len(args.scripts), num_failed, num_commands, elapsed))
+
+sys.exit(1 if num_failed > 0 else 0)
@@ -0,0 +1,84 @@
+'''
+EEZ PSU Firmware
+Copyright (C) 2015 Envox d.o.o.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+'''
+
+# Measures SCPI throughput of the simulator (or real PSU) over TCP.
+# Every client sends pipelined "VOLT x;CURR y" lines and waits for *OPC?
+# response. Clients run in parallel, each in its own SCPI session.
+#
+# usage: python scpi_throughput.py [host] [port] [lines] [clients]
+
+import socket
+import sys
+import threading
+import time
+
+host = sys.argv[1] if len(sys.argv) > 1 else 'localhost'
+port = int(sys.argv[2]) if len(sys.argv) > 2 else 5025
+num_lines = int(sys.argv[3]) if len(sys.argv) > 3 else 5000
+num_clients = int(sys.argv[4]) if len(sys.argv) > 4 else 1
+
+lines = []
+for i in range(num_lines):
+    lines.append('VOLT %.2f;CURR %.2f\n' % ((i % 400) / 100.0, (i % 300) / 100.0))
+script = ''.join(lines).encode('ascii')
+
+def read_line(s):
+    line = b''
+    while not line.endswith(b'\n'):
+        data = s.recv(1)
+        if not data:
+            break
+        line += data
+    return line.strip().decode()
+
+results = [None] * num_clients
+
+def client(index):
+    s = socket.create_connection((host, port))
+    s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+    start = time.time()
+    # error in the last line should be reported only to this session
+    s.sendall(script + b'*OPC?\nNOTACOMMAND\n*OPC?\n')
+    response = read_line(s)
+    read_line(s)
+    elapsed = time.time() - start
+
+    s.sendall(b'SYST:ERR?\n')
+    error1 = read_line(s)
+    s.sendall(b'SYST:ERR?\n')
+    error2 = read_line(s)
+    s.close()
+
+    results[index] = (elapsed, response, error1, error2)
+
+start = time.time()
+threads = [threading.Thread(target=client, args=(i,)) for i in range(num_clients)]
+for thread in threads:
+    thread.start()
+for thread in threads:
+    thread.join()
+elapsed = time.time() - start
+
+for i, (client_elapsed, response, error1, error2) in enumerate(results):
+    print('client %d: %.3f s, *OPC? -> %s, SYST:ERR? -> %s, %s' % (i + 1, client_elapsed, response, error1, error2))
+
+total_lines = num_lines * num_clients
+total_bytes = len(script) * num_clients
+print('%d clients, %d lines, %d bytes in %.3f s' % (num_clients, total_lines, total_bytes, elapsed))
+print('%.0f lines/s, %.0f bytes/s' % (total_lines / elapsed, total_bytes / elapsed))
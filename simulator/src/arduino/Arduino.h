@@ -19,6 +19,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdio.h>
 #include <queue>
 
 typedef uint8_t byte;
@@ -79,6 +80,8 @@ public:
 /// Bare minimum implementation of the Arduino Serial object
 class SimulatorSerial {
 public:
+    SimulatorSerial() : output(stdout) {}
+
     void begin(unsigned long baud);
     int write(const char *buffer, int size);
     int print(const char *data);
@@ -91,8 +94,12 @@ public:
 
     void put(int ch);
 
+    /// Redirect the output, by default it goes to stdout.
+    void setOutput(FILE *output_) { output = output_; }
+
 private:
     std::queue<int> input;
+    FILE *output;
 };
 
 extern SimulatorSerial Serial;
@@ -19,6 +19,7 @@
 #include "psu.h"
 #include "arduino_internal.h"
 #include "chips.h"
+#include "load_model.h"
 #include "temp_sensor.h"
 #include "front_panel/control.h"
 
@@ -48,7 +49,8 @@ void digitalWrite(uint8_t pin, uint8_t state) {
 
 int analogRead(uint8_t pin) {
     if (pin == TEMP_ANALOG) {
-        float cels = simulator::getTemperature(temp_sensor::MAIN);
+        // main temperature sensor is on the heat sink
+        float cels = simulator::getTemperature(temp_sensor::MAIN) + load_model::getTemperatureRise();
         float volt = util::remap(cels, MAIN_TEMP_COEF_P1_T, MAIN_TEMP_COEF_P1_U, MAIN_TEMP_COEF_P2_T, MAIN_TEMP_COEF_P2_U);
         float adc = util::remap(volt, (float)temp_sensor::MIN_U, (float)temp_sensor::MIN_ADC, (float)temp_sensor::MAX_U, (float)temp_sensor::MAX_ADC);
         return (int)util::clamp(adc, (float)temp_sensor::MIN_ADC, (float)temp_sensor::MAX_ADC);
@@ -72,7 +74,7 @@ void SimulatorSerial::begin(unsigned long baud) {
 }
 
 int SimulatorSerial::write(const char *buffer, int size) {
-    return fwrite(buffer, 1, size, stdout);
+    return fwrite(buffer, 1, size, output);
 }
 
 int SimulatorSerial::print(const char *data) {
@@ -80,15 +82,15 @@ int SimulatorSerial::print(const char *data) {
 }
 
 int SimulatorSerial::println(int value) {
-    return printf("%d\n", value);
+    return fprintf(output, "%d\n", value);
 }
 
 int SimulatorSerial::println(const char *data) {
-    return printf("%s\n", data);
+    return fprintf(output, "%s\n", data);
 }
 
 int SimulatorSerial::println(IPAddress ipAddress) {
-    return printf("%d.%d.%d.%d\n", ipAddress.bytes[0], ipAddress.bytes[1], ipAddress.bytes[2], ipAddress.bytes[3]);
+    return fprintf(output, "%d.%d.%d.%d\n", ipAddress.bytes[0], ipAddress.bytes[1], ipAddress.bytes[2], ipAddress.bytes[3]);
 }
 
 int SimulatorSerial::available(void) {
@@ -146,30 +148,15 @@ void tone(uint8_t _pin, unsigned int frequency, unsigned long duration) {
 #undef OUTPUT
 #include <Windows.h>
 #else
-#include <sys/time.h>
 #include <time.h>
 #endif
 
 uint32_t millis() {
-#ifdef _WIN32
-    return GetTickCount();
-#else
-    timeval tv;
-    gettimeofday(&tv, NULL);
-    uint64_t micros = tv.tv_sec*(uint64_t)1000000 + tv.tv_usec;
-    return (uint32_t)(micros / 1000);
-#endif
+    return (uint32_t)(simulator::getTime() / 1000);
 }
 
 uint32_t micros() {
-#ifdef _WIN32
-    return GetTickCount() * 1000;
-#else
-    timeval tv;
-    gettimeofday(&tv, NULL);
-    uint64_t micros = tv.tv_sec*(uint64_t)1000000 + tv.tv_usec;
-    return (uint32_t)(micros);
-#endif
+    return (uint32_t)simulator::getTime();
 }
 
 void delay(uint32_t millis) {
@@ -177,12 +164,18 @@ void delay(uint32_t millis) {
 }
 
 void delayMicroseconds(uint32_t microseconds) {
+    if (simulator::getTimeMode() == simulator::TIME_MODE_VIRTUAL) {
+        // virtual time passes without waiting
+        simulator::setTime(simulator::getTime() + microseconds);
+        return;
+    }
+
 #ifdef _WIN32
     Sleep(microseconds / 1000);
 #else
     timespec ts;
     ts.tv_sec = microseconds / 1000000;
-    ts.tv_nsec = (microseconds % 1000000) * 1000000;
+    ts.tv_nsec = (microseconds % 1000000) * 1000;
     nanosleep(&ts, 0);
 #endif
 }
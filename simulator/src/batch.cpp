@@ -0,0 +1,213 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2015 Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "psu.h"
+#include "serial_psu.h"
+#include "main_loop.h"
+#include "batch.h"
+
+namespace eez {
+namespace psu {
+namespace simulator {
+namespace batch {
+
+#define MAX_LINE_LENGTH 1024
+#define MAX_ERRORS 16
+
+/// Response buffer grows as needed, e.g. for FETCh:ARRay blocks.
+static char *response;
+static size_t response_size;
+static size_t response_length;
+static int16_t errors[MAX_ERRORS];
+static int num_errors;
+
+static bool running;
+static bool stopped;
+
+static size_t SCPI_Write(scpi_t *context, const char *data, size_t len) {
+    if (response_length + len > response_size) {
+        size_t size = response_size > 0 ? response_size : 4096;
+        while (response_length + len > size) {
+            size *= 2;
+        }
+        char *new_response = (char *)realloc(response, size);
+        if (!new_response) {
+            return 0;
+        }
+        response = new_response;
+        response_size = size;
+    }
+    memcpy(response + response_length, data, len);
+    response_length += len;
+    return len;
+}
+
+static int SCPI_Error(scpi_t *context, int_fast16_t err) {
+    if (err != 0 && num_errors < MAX_ERRORS) {
+        errors[num_errors++] = (int16_t)err;
+    }
+    return 0;
+}
+
+/// Run ticks until power up and time step are finished.
+static void waitInputUnblocked() {
+    while (isPowerUpInProgress() || isTimeStepPending()) {
+        advanceTime(TICK_TIMEOUT * 1000, true);
+        simulator::tick();
+    }
+}
+
+/// Write JSON string. Control characters and bytes >= 0x80 (e.g. binary block
+/// data of REAL,32 responses) are escaped as \u00XX, so every byte of the
+/// response maps to one character and the output is valid ASCII.
+static void writeString(FILE *fp, const char *str, size_t length) {
+    fputc('"', fp);
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char ch = (unsigned char)str[i];
+        if (ch == '"' || ch == '\\') {
+            fputc('\\', fp);
+            fputc(ch, fp);
+        }
+        else if (ch == '\n') {
+            fputs("\\n", fp);
+        }
+        else if (ch == '\r') {
+            fputs("\\r", fp);
+        }
+        else if (ch < 0x20 || ch >= 0x7f) {
+            fprintf(fp, "\\u%04x", ch);
+        }
+        else {
+            fputc(ch, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+bool isRunning() {
+    return running;
+}
+
+void stop() {
+    stopped = true;
+}
+
+int run(const char *script_path, const char *out_path) {
+    FILE *script = fopen(script_path, "r");
+    if (!script) {
+        fprintf(stderr, "Can't open script file %s\n", script_path);
+        return 2;
+    }
+
+    FILE *out = stdout;
+    if (out_path) {
+        out = fopen(out_path, "w");
+        if (!out) {
+            fprintf(stderr, "Can't open output file %s\n", out_path);
+            fclose(script);
+            return 2;
+        }
+    }
+
+    // responses and errors of the serial SCPI context go to the transcript,
+    // so registers and error queue are the same as in interactive session
+    scpi_interface_t interface = *serial::scpi_context.interface;
+    interface.write = SCPI_Write;
+    interface.error = SCPI_Error;
+    scpi_interface_t *serial_interface = serial::scpi_context.interface;
+    serial::scpi_context.interface = &interface;
+
+    int result = 0;
+    running = true;
+    stopped = false;
+
+    char line[MAX_LINE_LENGTH];
+    int line_number = 0;
+    while (!stopped && fgets(line, sizeof(line) - 1, script)) {
+        ++line_number;
+
+        size_t length = strlen(line);
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+            --length;
+        }
+        line[length] = 0;
+
+        if (length == 0 || line[0] == '#') {
+            continue;
+        }
+
+        waitInputUnblocked();
+
+        response_length = 0;
+        num_errors = 0;
+
+        uint64_t virtual_start = getTime();
+        uint64_t wall_start = getRealTime();
+
+        line[length] = '\n';
+        scpi::input(serial::scpi_context, line, length + 1);
+
+        // time step and power up started by this command belong to it
+        waitInputUnblocked();
+
+        uint64_t virtual_elapsed = getTime() - virtual_start;
+        uint64_t wall_elapsed = getRealTime() - wall_start;
+
+        while (response_length > 0 && (response[response_length - 1] == '\n' || response[response_length - 1] == '\r')) {
+            --response_length;
+        }
+
+        fprintf(out, "{\"line\":%d,\"command\":", line_number);
+        writeString(out, line, length);
+        fputs(",\"response\":", out);
+        writeString(out, response, response_length);
+        fputs(",\"errors\":[", out);
+        for (int i = 0; i < num_errors; ++i) {
+            const char *message = SCPI_ErrorTranslate(errors[i]);
+            fprintf(out, "%s{\"code\":%d,\"message\":", i > 0 ? "," : "", errors[i]);
+            writeString(out, message, strlen(message));
+            fputc('}', out);
+        }
+        fprintf(out, "],\"virtual_time_us\":%llu,\"wall_time_us\":%llu}\n",
+            (unsigned long long)virtual_elapsed, (unsigned long long)wall_elapsed);
+        fflush(out);
+
+        if (num_errors > 0) {
+            result = 1;
+        }
+    }
+
+    running = false;
+    serial::scpi_context.interface = serial_interface;
+
+    free(response);
+    response = 0;
+    response_size = 0;
+
+    fclose(script);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return result;
+}
+
+}
+}
+}
+} // namespace eez::psu::simulator::batch
@@ -0,0 +1,43 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2015 Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace eez {
+namespace psu {
+namespace simulator {
+/// Headless execution of SCPI command files.
+namespace batch {
+
+/// Execute SCPI commands from script_path, one per line, in virtual time with the clock stopped.
+/// Every line is recorded into out_path (or stdout, if 0) as JSON object with the command,
+/// response, errors generated and elapsed virtual and wall clock time.
+/// Response bytes >= 0x80 are written as \u0080 - \u00ff characters.
+/// Empty lines and lines starting with # are skipped.
+/// \returns 0 if all commands executed without errors, 1 if some failed and 2 if script
+/// or output file can't be opened.
+int run(const char *script_path, const char *out_path);
+
+bool isRunning();
+/// Stop after the current command, used by SIMUlator:EXIT.
+void stop();
+
+}
+}
+}
+} // namespace eez::psu::simulator::batch
@@ -19,6 +19,18 @@
 #include "psu.h"
 #include "chips.h"
 #include "arduino_internal.h"
+#include "load_model.h"
+
+#ifdef _WIN32
+#undef INPUT
+#undef OUTPUT
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 namespace eez {
 namespace psu {
@@ -63,6 +75,7 @@ void select(int pin, int state) {
         }
         else {
             if (selected_chip == &eeprom_chip) {
+                eeprom_chip.deselect();
                 selected_chip = 0;
             }
         }
@@ -161,6 +174,11 @@ uint8_t transfer(uint8_t data) {
     return selected_chip ? selected_chip->transfer(data) : 0;
 }
 
+void init() {
+    eeprom_chip.init();
+    rtc_chip.init();
+}
+
 void tick() {
     adc_chip1.tick();
     adc_chip2.tick();
@@ -169,23 +187,71 @@ void tick() {
 ////////////////////////////////////////////////////////////////////////////////
 
 EepromChip::EepromChip()
-    : state(IDLE)
+    : image(0)
+#ifdef _WIN32
+    , file_handle(INVALID_HANDLE_VALUE)
+    , mapping_handle(NULL)
+#else
+    , fd(-1)
+#endif
+    , dirty_begin(SIZE)
+    , dirty_end(0)
+    , state(IDLE)
 {
+}
+
+void EepromChip::init() {
     char *file_path = getConfFilePath("EEPROM.state");
-    fp = fopen(file_path, "r+b");
-    if (fp == NULL) {
-        fp = fopen(file_path, "w+b");
+
+    // File is extended to the full EEPROM size if needed, new bytes are zero
+    // (the same as reading past the end of the file was before).
+#ifdef _WIN32
+    file_handle = CreateFileA(file_path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file_handle != INVALID_HANDLE_VALUE) {
+        mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READWRITE, 0, SIZE, NULL);
+        if (mapping_handle != NULL) {
+            image = (uint8_t *)MapViewOfFile(mapping_handle, FILE_MAP_ALL_ACCESS, 0, 0, SIZE);
+        }
+    }
+#else
+    fd = open(file_path, O_RDWR | O_CREAT, 0644);
+    if (fd != -1) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && (st.st_size >= SIZE || ftruncate(fd, SIZE) == 0)) {
+            void *p = mmap(NULL, SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (p != MAP_FAILED) {
+                image = (uint8_t *)p;
+            }
+        }
     }
+#endif
 }
 
 EepromChip::~EepromChip() {
-    if (fp != NULL) fclose(fp);
+#ifdef _WIN32
+    if (image) {
+        FlushViewOfFile(image, SIZE);
+        UnmapViewOfFile(image);
+    }
+    if (mapping_handle != NULL) CloseHandle(mapping_handle);
+    if (file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+#else
+    if (image) {
+        msync(image, SIZE, MS_SYNC);
+        munmap(image, SIZE);
+    }
+    if (fd != -1) close(fd);
+#endif
 }
 
 void EepromChip::select() {
     state = IDLE;
 }
 
+void EepromChip::deselect() {
+    flush();
+}
+
 uint8_t EepromChip::transfer(uint8_t data) {
     uint8_t result = 0;
 
@@ -199,6 +265,9 @@ uint8_t EepromChip::transfer(uint8_t data) {
         else if (data == eeprom::RDSR) {
             state = RDSR;
         }
+        else if (data == eeprom::WRDI) {
+            flush();
+        }
     }
     else if (state == READ_ADDR_MSB) {
         address = ((uint16_t)data) << 8;
@@ -233,25 +302,44 @@ uint8_t EepromChip::transfer(uint8_t data) {
 }
 
 uint8_t EepromChip::read_byte() {
-    if (fp == NULL) return 0;
-    fseek(fp, address + address_index, SEEK_SET);
-    uint8_t data = 0;
-    fread(&data, 1, 1, fp);
-    return data;
+    uint32_t i = address + address_index;
+    if (!image || i >= SIZE) return 0;
+    return image[i];
 }
 
 void EepromChip::write_byte(uint8_t data) {
-    if (fp == NULL) return;
-    fseek(fp, address + address_index, SEEK_SET);
-    fwrite(&data, 1, 1, fp);
-    fflush(fp);
+    uint32_t i = address + address_index;
+    if (!image || i >= SIZE) return;
+    image[i] = data;
+    if (i < dirty_begin) dirty_begin = i;
+    if (i + 1 > dirty_end) dirty_end = i + 1;
+}
+
+void EepromChip::flush() {
+    if (dirty_begin >= dirty_end) return;
+
+#ifdef _WIN32
+    FlushViewOfFile(image + dirty_begin, dirty_end - dirty_begin);
+#else
+    // msync requires page aligned address
+    uint32_t begin = dirty_begin & ~((uint32_t)sysconf(_SC_PAGESIZE) - 1);
+    msync(image + begin, dirty_end - begin, MS_ASYNC);
+#endif
+
+    dirty_begin = SIZE;
+    dirty_end = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 RtcChip::RtcChip()
-    : state(IDLE)
+    : fp(NULL)
+    , offset(0)
+    , state(IDLE)
 {
+}
+
+void RtcChip::init() {
     char *file_path = getConfFilePath("RTC.state");
     fp = fopen(file_path, "r+b");
     if (fp == NULL) {
@@ -674,33 +762,35 @@ void AnalogDigitalConverterChip::updateValues() {
     for (int i = 0; i < CH_NUM; ++i) {
         Channel &channel = Channel::get(i);
         if (channel.convend_pin == convend_pin) {
+            load_model::Model &model = load_model::get(i);
+            model.setOutputEnabled(channel.isOutputEnabled());
+            if (!channel.isOutputEnabled()) {
+                model.reset();
+            }
+
             if (channel.simulator.getLoadEnabled()) {
                 float u_set_v = channel.remapAdcDataToVoltage(u_set);
                 float i_set_a = channel.remapAdcDataToCurrent(i_set);
 
-                float u_mon_v = i_set_a * channel.simulator.load;
-                float i_mon_a = i_set_a;
-                if (u_mon_v > u_set_v) {
-                    u_mon_v = u_set_v;
-                    i_mon_a = u_set_v / channel.simulator.load;
-
-                    ioexp_chip.cv = true;
-                    ioexp_chip.cc = false;
-                }
-                else {
-                    ioexp_chip.cv = false;
-                    ioexp_chip.cc = true;
-                }
+                float u_mon_v;
+                float i_mon_a;
+                model.update(channel, u_set_v, i_set_a, u_mon_v, i_mon_a, ioexp_chip.cv, ioexp_chip.cc);
 
-                u_mon = channel.remapVoltageToAdcData(u_mon_v);
-                i_mon = channel.remapCurrentToAdcData(i_mon_a);
+                u_mon = model.addNoise(channel.remapVoltageToAdcData(u_mon_v));
+                i_mon = model.addNoise(channel.remapCurrentToAdcData(i_mon_a));
 
                 return;
             }
             else {
                 if (channel.isOutputEnabled()) {
-                    u_mon = u_set;
-                    i_mon = 0;
+                    if (model.isSlewLimited()) {
+                        u_mon = channel.remapVoltageToAdcData(model.updateNoLoad(channel.remapAdcDataToVoltage(u_set)));
+                    }
+                    else {
+                        u_mon = u_set;
+                    }
+                    u_mon = model.addNoise(u_mon);
+                    i_mon = model.addNoise(0);
                     if (u_set > 0 && i_set > 0) {
                         ioexp_chip.cv = true;
                         ioexp_chip.cc = false;
@@ -45,6 +45,10 @@ void select(int pin, int state);
 /// \param pin Pin number
 uint8_t transfer(uint8_t data);
 
+/// Open the chips state files, called by simulator::init
+/// after the state directory is known.
+void init();
+
 /// This should be called periodically by the simulator main loop.
 /// For the case if some of the chips need to do something in the background.
 void tick();
@@ -74,14 +78,30 @@ class EepromChip : public Chip {
     };
 
 public:
+    /// AT25256B is 32 KB
+    static const uint32_t SIZE = 32768;
+
     EepromChip();
     ~EepromChip();
 
+    void init();
     void select();
+    void deselect();
     uint8_t transfer(uint8_t data);
 
 private:
-    FILE *fp;
+    /// EEPROM image, memory mapped EEPROM.state file
+    uint8_t *image;
+#ifdef _WIN32
+    void *file_handle;
+    void *mapping_handle;
+#else
+    int fd;
+#endif
+
+    /// Range of the image written since the last flush
+    uint32_t dirty_begin;
+    uint32_t dirty_end;
 
     State state;
     uint16_t address;
@@ -89,6 +109,7 @@ private:
 
     uint8_t read_byte();
     void write_byte(uint8_t);
+    void flush();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -124,6 +145,7 @@ public:
     RtcChip();
     ~RtcChip();
 
+    void init();
     void select();
     uint8_t transfer(uint8_t data);
 
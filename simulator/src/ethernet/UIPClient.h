@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include "ethernet_platform.h"
+
 namespace eez {
 namespace psu {
 namespace simulator {
@@ -27,10 +29,11 @@ namespace arduino {
 class EthernetClient {
 public:
     EthernetClient();
-    EthernetClient(bool valid);
+    EthernetClient(int id);
 
     operator bool();
-    bool operator==(EthernetClient &other) { return true; }
+    bool operator==(const EthernetClient &other) { return id != -1 && id == other.id; }
+    bool operator!=(const EthernetClient &other) { return !operator==(other); }
 
     bool connected();
 
@@ -41,7 +44,7 @@ public:
     void stop();
 
 private:
-    bool valid;
+    int id;
 };
 
 }
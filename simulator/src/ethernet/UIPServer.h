@@ -36,7 +36,6 @@ public:
 private:
     bool bind_result;
     int port;
-    EthernetClient client;
 };
 
 }
@@ -18,20 +18,26 @@
 
 #pragma once
 
+/// Max. number of simultaneously connected clients, same meaning as in UIPEthernet library.
+#define UIP_CONF_MAX_CONNECTIONS 4
+
 namespace eez {
 namespace psu {
 namespace ethernet_platform {
 
 bool bind(int port);
-bool client_available();
 
-bool connected();
+/// Accept new client connection.
+/// \returns Client id or -1 if there is no new connection.
+int accept();
+
+bool connected(int client);
 
-int available();
-int read(char *buffer, int buffer_size);
-int write(const char *buffer, int buffer_size);
+int available(int client);
+int read(int client, char *buffer, int buffer_size);
+int write(int client, const char *buffer, int buffer_size);
 
-void stop();
+void stop(int client);
 
 }
 }
@@ -58,48 +58,63 @@ IPAddress SimulatorEthernet::dnsServerIP() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EthernetServer::EthernetServer(int port_) : port(port_), client(true) {
+EthernetServer::EthernetServer(int port_) : port(port_) {
 }
 
 void EthernetServer::begin() {
+    // port can be changed from the simulator command line
+    port = simulator::getTcpPort();
     bind_result = ethernet_platform::bind(port);
 }
 
 EthernetClient EthernetServer::available() {
     if (!bind_result) return EthernetClient();
-    return client;
+
+    while (ethernet_platform::accept() != -1) {
+    }
+
+    // as in UIPEthernet, return the first client with received data
+    for (int i = 0; i < UIP_CONF_MAX_CONNECTIONS; ++i) {
+        if (ethernet_platform::available(i) > 0) {
+            return EthernetClient(i);
+        }
+    }
+
+    return EthernetClient();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EthernetClient::EthernetClient() : valid(false) {
+EthernetClient::EthernetClient() : id(-1) {
 }
 
-EthernetClient::EthernetClient(bool valid_) : valid(valid_) {
+EthernetClient::EthernetClient(int id_) : id(id_) {
 }
 
 bool EthernetClient::connected() {
-    return ethernet_platform::connected();
+    return id != -1 && ethernet_platform::connected(id);
 }
 
 EthernetClient::operator bool() {
-    return valid && ethernet_platform::client_available();
+    return connected();
 }
 
 size_t EthernetClient::available() {
-    return ethernet_platform::available();
+    return id != -1 ? ethernet_platform::available(id) : 0;
 }
 
 size_t EthernetClient::read(uint8_t* buffer, size_t buffer_size) {
-    return ethernet_platform::read((char *)buffer, (int)buffer_size);
+    return id != -1 ? ethernet_platform::read(id, (char *)buffer, (int)buffer_size) : 0;
 }
 
 size_t EthernetClient::write(const char *buffer, size_t buffer_size) {
-    return ethernet_platform::write(buffer, (int)buffer_size);
+    return id != -1 ? ethernet_platform::write(id, buffer, (int)buffer_size) : 0;
 }
 
 void EthernetClient::stop() {
-    ethernet_platform::stop();
+    if (id != -1) {
+        ethernet_platform::stop(id);
+    }
 }
 
 }
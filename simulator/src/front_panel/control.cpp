@@ -59,12 +59,12 @@ void load_lib() {
         if (g_lib) {
             g_create_window_ptr = (create_window_ptr_t)eez_dll_get_proc_address(g_lib, "eez_imgui_create_window");
             if (!g_create_window_ptr) {
-                printf("Incompatible GUI library!\n");
+                fprintf(stderr, "Incompatible GUI library!\n");
             }
             g_beep_ptr = (beep_ptr_t)eez_dll_get_proc_address(g_lib, "eez_imgui_beep");
         }
         else {
-            printf("GUI library could not be loaded!\n");
+            fprintf(stderr, "GUI library could not be loaded!\n");
         }
         g_lib_loaded = true;
     }
@@ -0,0 +1,272 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2015 Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "psu.h"
+#include "load_model.h"
+
+namespace eez {
+namespace psu {
+namespace simulator {
+namespace load_model {
+
+static Model models[CH_MAX];
+
+static float thermal_resistance = SIM_THERMAL_RESISTANCE_DEF;
+static float temperature_rise = 0;
+static uint32_t thermal_last_update = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Voltage of the capacitor after dt seconds, if charged with current i
+/// and discharged through resistor r.
+static float charge(float u0, float i, float r, float c, float dt) {
+    if (isinf(r)) {
+        return u0 + i / c * dt;
+    }
+    float u_final = i * r;
+    return u_final + (u0 - u_final) * expf(-dt / (r * c));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Model::Model()
+    : mode(MODE_RESISTANCE)
+    , current(SIM_LOAD_CURRENT_DEF)
+    , power(SIM_LOAD_POWER_DEF)
+    , capacitance(SIM_LOAD_CAPACITANCE_DEF)
+    , list_count(0)
+    , dwell(SIM_LOAD_DWELL_DEF)
+    , slew(SIM_SLEW_DEF)
+    , noise(SIM_NOISE_DEF)
+    , last_update(0)
+    , list_start(0)
+    , u_out(0)
+    , i_out(0)
+    , random(0x12345678)
+    , output_enabled(false)
+{
+}
+
+void Model::setMode(Mode mode_) {
+    mode = mode_;
+    list_start = micros();
+}
+
+void Model::setList(const float *values, int count) {
+    for (int i = 0; i < count; ++i) {
+        list[i] = values[i];
+    }
+    list_count = count;
+    list_start = micros();
+}
+
+float Model::getDeltaTime() {
+    uint32_t now = micros();
+    float dt = (now - last_update) / 1000000.0f;
+    last_update = now;
+    return dt;
+}
+
+void Model::update(Channel &channel, float u_set, float i_set, float &u_mon, float &i_mon, bool &cv, bool &cc) {
+    float dt = getDeltaTime();
+
+    float load = channel.simulator.load;
+    if (mode == MODE_LIST && list_count > 0) {
+        uint32_t index = (uint32_t)((micros() - list_start) / (dwell * 1000000.0f));
+        load = list[index % list_count];
+    }
+
+    float u;
+    float i;
+
+    if (mode == MODE_RC) {
+        if (u_out >= u_set && u_set / load <= i_set) {
+            if (u_out > u_set) {
+                // regulator doesn't sink current, capacitor is discharged through the resistor only
+                u = charge(u_out, 0, load, capacitance, dt);
+                if (u < u_set) {
+                    u = u_set;
+                }
+                i = 0;
+                cv = false;
+                cc = false;
+            }
+            else {
+                u = u_set;
+                i = u_set / load;
+                cv = true;
+                cc = false;
+            }
+        }
+        else {
+            // capacitor is charged with the current limit
+            u = charge(u_out, i_set, load, capacitance, dt);
+            if (u > u_set) {
+                u = u_set;
+                i = u_set / load;
+                cv = true;
+                cc = false;
+            }
+            else {
+                i = i_set;
+                cv = false;
+                cc = true;
+            }
+        }
+    }
+    else if (mode == MODE_CURRENT || mode == MODE_POWER) {
+        i = mode == MODE_CURRENT ? current : (u_set > 0 ? power / u_set : 0);
+        if (i <= i_set) {
+            u = u_set;
+            cv = true;
+            cc = false;
+        }
+        else {
+            // load takes more then current limit, so the output voltage collapses
+            u = 0;
+            i = i_set;
+            cv = false;
+            cc = true;
+        }
+    }
+    else {
+        u = i_set * load;
+        i = i_set;
+        if (u > u_set) {
+            u = u_set;
+            i = u_set / load;
+
+            cv = true;
+            cc = false;
+        }
+        else {
+            cv = false;
+            cc = true;
+        }
+    }
+
+    if (isSlewLimited()) {
+        float du = slew * dt;
+        float u_limited = util::clamp(u, u_out - du, u_out + du);
+        if (u_limited != u) {
+            // current follows the voltage
+            i = u > 0 ? i * u_limited / u : 0;
+            u = u_limited;
+        }
+    }
+
+    u_out = u;
+    i_out = i;
+
+    u_mon = u;
+    i_mon = i;
+}
+
+float Model::updateNoLoad(float u_set) {
+    float dt = getDeltaTime();
+
+    float du = slew * dt;
+    u_out = util::clamp(u_set, u_out - du, u_out + du);
+    i_out = 0;
+
+    return u_out;
+}
+
+void Model::reset() {
+    last_update = micros();
+    u_out = 0;
+    i_out = 0;
+}
+
+void Model::setOutputEnabled(bool enabled) {
+    if (enabled != output_enabled) {
+        output_enabled = enabled;
+        reset();
+    }
+}
+
+bool Model::isSlewLimited() {
+    return !isinf(slew);
+}
+
+uint16_t Model::addNoise(uint16_t adc_data) {
+    if (noise == 0) {
+        return adc_data;
+    }
+
+    // xorshift, so the noise is the same in every run
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+
+    float value = adc_data + noise * (2.0f * random / 4294967295.0f - 1.0f);
+    return (uint16_t)util::clamp(floorf(value + 0.5f),
+        (float)AnalogDigitalConverter::ADC_MIN, (float)AnalogDigitalConverter::ADC_MAX);
+}
+
+float Model::getDissipatedPower(Channel &channel) {
+    float u = channel.U_MAX - u_out;
+    return u > 0 ? u * i_out : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Model &get(int channel_index) {
+    return models[channel_index];
+}
+
+void setThermalResistance(float value) {
+    thermal_resistance = value;
+}
+
+float getThermalResistance() {
+    return thermal_resistance;
+}
+
+float getTemperatureRise() {
+    return temperature_rise;
+}
+
+void tick() {
+    uint32_t now = micros();
+    float dt = (now - thermal_last_update) / 1000000.0f;
+    thermal_last_update = now;
+
+    float power = 0;
+    for (int i = 0; i < CH_NUM; ++i) {
+        Channel &channel = Channel::get(i);
+        // ADC conversions are not running while the output is off,
+        // so the output state change is also tracked here
+        models[i].setOutputEnabled(channel.isOutputEnabled());
+        if (channel.isOutputEnabled()) {
+            power += models[i].getDissipatedPower(channel);
+        }
+    }
+
+    // first order model of the heat sink
+    float k = dt / SIM_THERMAL_TIME_CONSTANT;
+    if (k > 1) {
+        k = 1;
+    }
+    temperature_rise += (power * thermal_resistance - temperature_rise) * k;
+}
+
+}
+}
+}
+} // namespace eez::psu::simulator::load_model
@@ -0,0 +1,111 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2015 Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace eez {
+namespace psu {
+
+class Channel;
+
+namespace simulator {
+/// Model of the channel output (regulator and load) used by the ADC chip simulation.
+namespace load_model {
+
+enum Mode {
+    /// Resistive load, resistance is Channel::Simulator::load.
+    MODE_RESISTANCE,
+    /// Constant current load.
+    MODE_CURRENT,
+    /// Constant power load.
+    MODE_POWER,
+    /// Resistive load with capacitor in parallel.
+    MODE_RC,
+    /// Resistive load which goes through the list of resistance values,
+    /// Channel::Simulator::load is used while the list is empty.
+    MODE_LIST
+};
+
+/// Per channel model parameters and state.
+class Model {
+public:
+    Mode mode;
+    /// Load current in A for MODE_CURRENT.
+    float current;
+    /// Load power in W for MODE_POWER.
+    float power;
+    /// Capacitance in F for MODE_RC.
+    float capacitance;
+    /// Resistance values in ohm for MODE_LIST.
+    float list[SIM_LOAD_LIST_SIZE];
+    int list_count;
+    /// Time in seconds of every list value.
+    float dwell;
+    /// Max. rate of the output voltage change in V/s, INFINITY if not limited.
+    float slew;
+    /// Max. ADC noise in LSB added to U_MON and I_MON.
+    float noise;
+
+    Model();
+
+    void setMode(Mode mode);
+    void setList(const float *values, int count);
+
+    /// Calculates output voltage and current of the channel with the load connected.
+    void update(Channel &channel, float u_set, float i_set, float &u_mon, float &i_mon, bool &cv, bool &cc);
+    /// Calculates output voltage of the channel without the load.
+    float updateNoLoad(float u_set);
+    /// Output is off, capacitor is discharged.
+    void reset();
+    /// Resets the model when the output is switched on or off, so the first
+    /// update after the output is enabled starts from 0 V.
+    void setOutputEnabled(bool enabled);
+
+    bool isSlewLimited();
+    uint16_t addNoise(uint16_t adc_data);
+
+    /// Power dissipated in the regulator, input voltage is taken to be U_MAX.
+    float getDissipatedPower(Channel &channel);
+
+private:
+    uint32_t last_update;
+    uint32_t list_start;
+    float u_out;
+    float i_out;
+    uint32_t random;
+    bool output_enabled;
+
+    float getDeltaTime();
+};
+
+Model &get(int channel_index);
+
+void setThermalResistance(float value);
+float getThermalResistance();
+
+/// Temperature of the heat sink above the ambient (SIMUlator:TEMPerature),
+/// i.e. the main temperature sensor.
+float getTemperatureRise();
+
+/// Updates the heat sink temperature, called from simulator::tick.
+void tick();
+
+}
+}
+}
+} // namespace eez::psu::simulator::load_model
@@ -18,12 +18,77 @@
 
 #include "psu.h"
 #include "main_loop.h"
+#include "batch.h"
 #include "front_panel/control.h"
 
 using namespace eez::psu;
 
-int main() {
+static void usage() {
+    fprintf(stderr, "usage: eez_psu_sim [--state-dir <dir>] [--port <port>] [--script <file> [--out <file>]]\n");
+}
+
+int main(int argc, char **argv) {
+    const char *script_path = 0;
+    const char *out_path = 0;
+
+    // several simulators can run at the same time, each with its own state and port
+    const char *state_dir = getenv("EEZ_PSU_SIM_STATE_DIR");
+    const char *port = getenv("EEZ_PSU_SIM_PORT");
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--state-dir") == 0 && i + 1 < argc) {
+            state_dir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = argv[++i];
+        }
+        else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            script_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        }
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (out_path && !script_path) {
+        usage();
+        return 2;
+    }
+
+    if (state_dir && *state_dir) {
+        simulator::setStateDir(state_dir);
+    }
+
+    if (port && *port) {
+        int tcp_port = atoi(port);
+        if (tcp_port <= 0 || tcp_port > 65535) {
+            usage();
+            return 2;
+        }
+        simulator::setTcpPort(tcp_port);
+    }
+
     simulator::init();
+
+    if (script_path) {
+        // transcript owns stdout, everything else goes to stderr
+        Serial.setOutput(stderr);
+
+        // script runs as fast as possible and time advances only when
+        // script waits with SIMUlator:TIME:STEP or for power up,
+        // clock starts from 0 like after MCU reset, so runs are reproducible
+        simulator::setTimeMode(simulator::TIME_MODE_VIRTUAL);
+        simulator::setTimeRate(0);
+        simulator::setTime(0);
+
+        boot();
+        return simulator::batch::run(script_path, out_path);
+    }
+
     boot();
 	main_loop();
     simulator::front_panel::close();
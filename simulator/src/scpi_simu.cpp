@@ -22,8 +22,11 @@
 #include "scpi_simu.h"
 
 #include "simulator_psu.h"
+#include "load_model.h"
 #include "chips.h"
 #include "front_panel/control.h"
+#include "persist_conf.h"
+#include "profile.h"
 
 namespace eez {
 namespace psu {
@@ -34,6 +37,23 @@ namespace scpi {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static scpi_choice_def_t load_mode_choice[] = {
+    { "RESistance", load_model::MODE_RESISTANCE },
+    { "CURRent", load_model::MODE_CURRENT },
+    { "POWer", load_model::MODE_POWER },
+    { "RC", load_model::MODE_RC },
+    { "LIST", load_model::MODE_LIST },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+static scpi_choice_def_t time_mode_choice[] = {
+    { "REAL", TIME_MODE_REAL },
+    { "VIRTual", TIME_MODE_VIRTUAL },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool get_resistance_from_param(scpi_t *context, const scpi_number_t &param, float &value) {
     if (param.special) {
         if (param.tag == SCPI_NUM_MAX) {
@@ -77,6 +97,89 @@ static bool get_resistance_param(scpi_t *context, float &value) {
     return get_resistance_from_param(context, param, value);
 }
 
+/// Load model parameter with MIN, MAX and DEF (and INF if allowed) special values.
+static bool get_model_param(scpi_t *context, float &value, float min, float max, float def, bool inf = false, scpi_unit_t unit = SCPI_UNIT_NONE) {
+    scpi_number_t param;
+    if (!SCPI_ParamNumber(context, scpi_special_numbers_def, &param, true)) {
+        return false;
+    }
+
+    if (param.special) {
+        if (param.tag == SCPI_NUM_MAX) {
+            value = max;
+        }
+        else if (param.tag == SCPI_NUM_MIN) {
+            value = min;
+        }
+        else if (param.tag == SCPI_NUM_DEF) {
+            value = def;
+        }
+        else if (param.tag == SCPI_NUM_INF && inf) {
+            value = INFINITY;
+        }
+        else {
+            SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+            return false;
+        }
+    }
+    else {
+        if (param.unit != SCPI_UNIT_NONE && param.unit != unit) {
+            SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
+            return false;
+        }
+
+        value = (float)param.value;
+        if (value < min || value > max) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Send float value in full precision, infinity as 9.9E37 (SCPI representation of INFinity).
+static scpi_result_t result_float_inf(scpi_t *context, float value) {
+    if (isinf(value)) {
+        value = value > 0 ? 9.9E37f : -9.9E37f;
+    }
+    return result_float(context, value, true);
+}
+
+static scpi_result_t result_model_param(scpi_t *context, float value, float min, float max, float def) {
+    int32_t spec;
+    if (!SCPI_ParamChoice(context, scpi_special_numbers_def, &spec, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+    }
+    else {
+        if (spec == SCPI_NUM_MIN) {
+            value = min;
+        }
+        else if (spec == SCPI_NUM_MAX) {
+            value = max;
+        }
+        else if (spec == SCPI_NUM_DEF) {
+            value = def;
+        }
+        else {
+            SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+            return SCPI_RES_ERR;
+        }
+    }
+
+    return result_float_inf(context, value);
+}
+
+static load_model::Model *param_model(scpi_t *context) {
+    Channel *channel = param_channel(context, FALSE, TRUE);
+    if (!channel) {
+        return 0;
+    }
+    return &load_model::get(channel->index - 1);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 scpi_result_t scpi_simu_LoadState(scpi_t *context) {
@@ -157,6 +260,243 @@ scpi_result_t scpi_simu_LoadQ(scpi_t *context) {
     return result_float(context, value);
 }
 
+scpi_result_t scpi_simu_LoadMode(scpi_t *context) {
+    int32_t mode;
+    if (!SCPI_ParamChoice(context, load_mode_choice, &mode, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    model->setMode((load_model::Mode)mode);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_LoadModeQ(scpi_t *context) {
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    static const char *mode_names[] = { "RES", "CURR", "POW", "RC", "LIST" };
+    const char *mode_name = mode_names[model->mode];
+    SCPI_ResultCharacters(context, mode_name, strlen(mode_name));
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_LoadCurrent(scpi_t *context) {
+    float value;
+    if (!get_model_param(context, value, SIM_LOAD_CURRENT_MIN, SIM_LOAD_CURRENT_MAX, SIM_LOAD_CURRENT_DEF, false, SCPI_UNIT_AMPER)) {
+        return SCPI_RES_ERR;
+    }
+
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    model->current = value;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_LoadCurrentQ(scpi_t *context) {
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    return result_model_param(context, model->current, SIM_LOAD_CURRENT_MIN, SIM_LOAD_CURRENT_MAX, SIM_LOAD_CURRENT_DEF);
+}
+
+scpi_result_t scpi_simu_LoadPower(scpi_t *context) {
+    float value;
+    if (!get_model_param(context, value, SIM_LOAD_POWER_MIN, SIM_LOAD_POWER_MAX, SIM_LOAD_POWER_DEF)) {
+        return SCPI_RES_ERR;
+    }
+
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    model->power = value;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_LoadPowerQ(scpi_t *context) {
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    return result_model_param(context, model->power, SIM_LOAD_POWER_MIN, SIM_LOAD_POWER_MAX, SIM_LOAD_POWER_DEF);
+}
+
+scpi_result_t scpi_simu_LoadCapacitance(scpi_t *context) {
+    float value;
+    if (!get_model_param(context, value, SIM_LOAD_CAPACITANCE_MIN, SIM_LOAD_CAPACITANCE_MAX, SIM_LOAD_CAPACITANCE_DEF)) {
+        return SCPI_RES_ERR;
+    }
+
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    model->capacitance = value;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_LoadCapacitanceQ(scpi_t *context) {
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    return result_model_param(context, model->capacitance, SIM_LOAD_CAPACITANCE_MIN, SIM_LOAD_CAPACITANCE_MAX, SIM_LOAD_CAPACITANCE_DEF);
+}
+
+// list is always set for the selected channel, because numeric
+// list can't be followed by the optional channel parameter
+scpi_result_t scpi_simu_LoadList(scpi_t *context) {
+    float values[SIM_LOAD_LIST_SIZE];
+    int count = 0;
+
+    scpi_number_t param;
+    while (SCPI_ParamNumber(context, scpi_special_numbers_def, &param, count == 0)) {
+        if (count == SIM_LOAD_LIST_SIZE) {
+            SCPI_ErrorPush(context, SCPI_ERROR_TOO_MUCH_DATA);
+            return SCPI_RES_ERR;
+        }
+
+        if (!get_resistance_from_param(context, param, values[count])) {
+            return SCPI_RES_ERR;
+        }
+
+        ++count;
+    }
+
+    if (SCPI_ParamErrorOccurred(context)) {
+        return SCPI_RES_ERR;
+    }
+
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    model->setList(values, count);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_LoadListQ(scpi_t *context) {
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    return result_float_array(context, model->list, model->list_count);
+}
+
+scpi_result_t scpi_simu_LoadListDwell(scpi_t *context) {
+    float value;
+    if (!get_model_param(context, value, SIM_LOAD_DWELL_MIN, SIM_LOAD_DWELL_MAX, SIM_LOAD_DWELL_DEF, false, SCPI_UNIT_SECONDS)) {
+        return SCPI_RES_ERR;
+    }
+
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    model->dwell = value;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_LoadListDwellQ(scpi_t *context) {
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    return result_model_param(context, model->dwell, SIM_LOAD_DWELL_MIN, SIM_LOAD_DWELL_MAX, SIM_LOAD_DWELL_DEF);
+}
+
+scpi_result_t scpi_simu_Slew(scpi_t *context) {
+    float value;
+    if (!get_model_param(context, value, SIM_SLEW_MIN, SIM_SLEW_MAX, SIM_SLEW_DEF, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    model->slew = value;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_SlewQ(scpi_t *context) {
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    return result_model_param(context, model->slew, SIM_SLEW_MIN, SIM_SLEW_MAX, SIM_SLEW_DEF);
+}
+
+scpi_result_t scpi_simu_Noise(scpi_t *context) {
+    float value;
+    if (!get_model_param(context, value, SIM_NOISE_MIN, SIM_NOISE_MAX, SIM_NOISE_DEF)) {
+        return SCPI_RES_ERR;
+    }
+
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    model->noise = value;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_NoiseQ(scpi_t *context) {
+    load_model::Model *model = param_model(context);
+    if (!model) {
+        return SCPI_RES_ERR;
+    }
+
+    return result_model_param(context, model->noise, SIM_NOISE_MIN, SIM_NOISE_MAX, SIM_NOISE_DEF);
+}
+
+scpi_result_t scpi_simu_ThermalResistance(scpi_t *context) {
+    float value;
+    if (!get_model_param(context, value, SIM_THERMAL_RESISTANCE_MIN, SIM_THERMAL_RESISTANCE_MAX, SIM_THERMAL_RESISTANCE_DEF)) {
+        return SCPI_RES_ERR;
+    }
+
+    load_model::setThermalResistance(value);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_ThermalResistanceQ(scpi_t *context) {
+    return result_model_param(context, load_model::getThermalResistance(), SIM_THERMAL_RESISTANCE_MIN, SIM_THERMAL_RESISTANCE_MAX, SIM_THERMAL_RESISTANCE_DEF);
+}
+
 scpi_result_t scpi_simu_Pwrgood(scpi_t *context) {
     bool on;
     if (!SCPI_ParamBool(context, &on, TRUE)) {
@@ -241,6 +581,130 @@ scpi_result_t scpi_simu_TemperatureQ(scpi_t *context) {
     return result_float(context, value);
 }
 
+scpi_result_t scpi_simu_Time(scpi_t *context) {
+    scpi_number_t param;
+    if (!SCPI_ParamNumber(context, 0, &param, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    if (param.unit != SCPI_UNIT_NONE && param.unit != SCPI_UNIT_SECONDS) {
+        SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
+        return SCPI_RES_ERR;
+    }
+
+    if (param.value < 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    simulator::setTime((uint64_t)(param.value * 1000000 + 0.5));
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_TimeQ(scpi_t *context) {
+    // in seconds
+    SCPI_ResultDouble(context, simulator::getTime() / 1000000.0);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_TimeMode(scpi_t *context) {
+    int32_t mode;
+    if (!SCPI_ParamChoice(context, time_mode_choice, &mode, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+
+    simulator::setTimeMode((TimeMode)mode);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_TimeModeQ(scpi_t *context) {
+    if (simulator::getTimeMode() == TIME_MODE_VIRTUAL) {
+        SCPI_ResultCharacters(context, "VIRT", 4);
+    }
+    else {
+        SCPI_ResultCharacters(context, "REAL", 4);
+    }
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_TimeRate(scpi_t *context) {
+    scpi_number_t param;
+    if (!SCPI_ParamNumber(context, scpi_special_numbers_def, &param, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    float value;
+    if (param.special) {
+        if (param.tag == SCPI_NUM_MAX) {
+            value = SIM_TIME_RATE_MAX;
+        }
+        else if (param.tag == SCPI_NUM_MIN) {
+            value = SIM_TIME_RATE_MIN;
+        }
+        else if (param.tag == SCPI_NUM_DEF) {
+            value = SIM_TIME_RATE_DEF;
+        }
+        else if (param.tag == SCPI_NUM_INF) {
+            value = INFINITY;
+        }
+        else {
+            SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+            return SCPI_RES_ERR;
+        }
+    }
+    else {
+        if (param.unit != SCPI_UNIT_NONE) {
+            SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
+            return SCPI_RES_ERR;
+        }
+
+        value = (float)param.value;
+        if (value < SIM_TIME_RATE_MIN || value > SIM_TIME_RATE_MAX) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return SCPI_RES_ERR;
+        }
+    }
+
+    simulator::setTimeRate(value);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_TimeRateQ(scpi_t *context) {
+    return result_float_inf(context, simulator::getTimeRate());
+}
+
+scpi_result_t scpi_simu_TimeStep(scpi_t *context) {
+    scpi_number_t param;
+    if (!SCPI_ParamNumber(context, 0, &param, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    if (param.unit != SCPI_UNIT_NONE && param.unit != SCPI_UNIT_SECONDS) {
+        SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
+        return SCPI_RES_ERR;
+    }
+
+    if (param.value <= 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    // time can be stepped only if it is virtual
+    if (simulator::getTimeMode() != TIME_MODE_VIRTUAL) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    simulator::stepTime((uint64_t)(param.value * 1000000 + 0.5));
+
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_simu_GUI(scpi_t *context) {
     if (!simulator::front_panel::open()) {
         SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
@@ -250,6 +714,116 @@ scpi_result_t scpi_simu_GUI(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_simu_BenchmarkParserQ(scpi_t *context) {
+    int32_t iterations;
+    if (!SCPI_ParamInt(context, &iterations, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        iterations = 1000;
+    }
+
+    if (iterations < 1) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    float linear;
+    float indexed;
+    benchmarkCommandDispatch(iterations, linear, indexed);
+
+    // commands per second without and with command index
+    SCPI_ResultFloat(context, linear);
+    SCPI_ResultFloat(context, indexed);
+
+    return SCPI_RES_OK;
+}
+
+static float benchmarkCrc32(uint32_t(*crc32)(const uint8_t *, size_t), const uint8_t *block, size_t size, uint32_t iterations, uint32_t &crc) {
+    uint64_t start = simulator::getRealTime();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        crc = crc32(block, size);
+    }
+    uint64_t elapsed = simulator::getRealTime() - start;
+
+    return (float)elapsed / iterations;
+}
+
+scpi_result_t scpi_simu_BenchmarkCrcQ(scpi_t *context) {
+    int32_t iterations;
+    if (!SCPI_ParamInt(context, &iterations, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        iterations = 10000;
+    }
+
+    if (iterations < 1) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    // checksum is calculated over profile block without checksum field
+    uint8_t block[sizeof(profile::Parameters)];
+    for (size_t i = 0; i < sizeof(block); ++i) {
+        block[i] = (uint8_t)(i * 31 + 7);
+    }
+    const uint8_t *message = block + sizeof(uint32_t);
+    size_t size = sizeof(block) - sizeof(uint32_t);
+
+    uint32_t crc_bitwise;
+    uint32_t crc_table;
+    uint32_t crc_slice_by_8;
+
+    float bitwise = benchmarkCrc32(util::crc32Bitwise, message, size, iterations, crc_bitwise);
+    float table = benchmarkCrc32(util::crc32Table, message, size, iterations, crc_table);
+    float slice_by_8 = benchmarkCrc32(util::crc32SliceBy8, message, size, iterations, crc_slice_by_8);
+
+    if (crc_table != crc_bitwise || crc_slice_by_8 != crc_bitwise) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    // microseconds per profile block
+    SCPI_ResultFloat(context, bitwise);
+    SCPI_ResultFloat(context, table);
+    SCPI_ResultFloat(context, slice_by_8);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_simu_BenchmarkAdcQ(scpi_t *context) {
+    int32_t iterations;
+    if (!SCPI_ParamInt(context, &iterations, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        iterations = 1000000;
+    }
+
+    if (iterations < 1) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    Channel *channel = param_channel(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    float remap_ns;
+    float float_ns;
+    float fixed_ns;
+    channel->benchmarkAdcConversion(iterations, remap_ns, float_ns, fixed_ns);
+
+    // nanoseconds per ADC data conversion
+    SCPI_ResultFloat(context, remap_ns);
+    SCPI_ResultFloat(context, float_ns);
+    SCPI_ResultFloat(context, fixed_ns);
+
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_simu_Exit(scpi_t *context) {
     simulator::exit();
 
@@ -23,11 +23,39 @@
     SCPI_COMMAND("SIMUlator:LOAD:STATe?", scpi_simu_LoadStateQ) \
     SCPI_COMMAND("SIMUlator:LOAD", scpi_simu_Load) \
     SCPI_COMMAND("SIMUlator:LOAD?", scpi_simu_LoadQ) \
+    SCPI_COMMAND("SIMUlator:LOAD:MODE", scpi_simu_LoadMode) \
+    SCPI_COMMAND("SIMUlator:LOAD:MODE?", scpi_simu_LoadModeQ) \
+    SCPI_COMMAND("SIMUlator:LOAD:CURRent", scpi_simu_LoadCurrent) \
+    SCPI_COMMAND("SIMUlator:LOAD:CURRent?", scpi_simu_LoadCurrentQ) \
+    SCPI_COMMAND("SIMUlator:LOAD:POWer", scpi_simu_LoadPower) \
+    SCPI_COMMAND("SIMUlator:LOAD:POWer?", scpi_simu_LoadPowerQ) \
+    SCPI_COMMAND("SIMUlator:LOAD:CAPacitance", scpi_simu_LoadCapacitance) \
+    SCPI_COMMAND("SIMUlator:LOAD:CAPacitance?", scpi_simu_LoadCapacitanceQ) \
+    SCPI_COMMAND("SIMUlator:LOAD:LIST", scpi_simu_LoadList) \
+    SCPI_COMMAND("SIMUlator:LOAD:LIST?", scpi_simu_LoadListQ) \
+    SCPI_COMMAND("SIMUlator:LOAD:LIST:DWELl", scpi_simu_LoadListDwell) \
+    SCPI_COMMAND("SIMUlator:LOAD:LIST:DWELl?", scpi_simu_LoadListDwellQ) \
+    SCPI_COMMAND("SIMUlator:SLEW", scpi_simu_Slew) \
+    SCPI_COMMAND("SIMUlator:SLEW?", scpi_simu_SlewQ) \
+    SCPI_COMMAND("SIMUlator:NOISe", scpi_simu_Noise) \
+    SCPI_COMMAND("SIMUlator:NOISe?", scpi_simu_NoiseQ) \
+    SCPI_COMMAND("SIMUlator:THERmal:RESistance", scpi_simu_ThermalResistance) \
+    SCPI_COMMAND("SIMUlator:THERmal:RESistance?", scpi_simu_ThermalResistanceQ) \
     SCPI_COMMAND("SIMUlator:PWRGood", scpi_simu_Pwrgood) \
     SCPI_COMMAND("SIMUlator:PWRGood?", scpi_simu_PwrgoodQ) \
     SCPI_COMMAND("SIMUlator:TEMPerature", scpi_simu_Temperature) \
     SCPI_COMMAND("SIMUlator:TEMPerature?", scpi_simu_TemperatureQ) \
+    SCPI_COMMAND("SIMUlator:TIME[:NOW]", scpi_simu_Time) \
+    SCPI_COMMAND("SIMUlator:TIME[:NOW]?", scpi_simu_TimeQ) \
+    SCPI_COMMAND("SIMUlator:TIME:MODE", scpi_simu_TimeMode) \
+    SCPI_COMMAND("SIMUlator:TIME:MODE?", scpi_simu_TimeModeQ) \
+    SCPI_COMMAND("SIMUlator:TIME:RATE", scpi_simu_TimeRate) \
+    SCPI_COMMAND("SIMUlator:TIME:RATE?", scpi_simu_TimeRateQ) \
+    SCPI_COMMAND("SIMUlator:TIME:STEP", scpi_simu_TimeStep) \
     SCPI_COMMAND("SIMUlator:GUI", scpi_simu_GUI) \
+    SCPI_COMMAND("SIMUlator:BENChmark:PARSer?", scpi_simu_BenchmarkParserQ) \
+    SCPI_COMMAND("SIMUlator:BENChmark:CRC?", scpi_simu_BenchmarkCrcQ) \
+    SCPI_COMMAND("SIMUlator:BENChmark:ADC?", scpi_simu_BenchmarkAdcQ) \
     SCPI_COMMAND("SIMUlator:EXIT", scpi_simu_Exit) \
     SCPI_COMMAND("SIMUlator:QUIT", scpi_simu_Exit) \
 
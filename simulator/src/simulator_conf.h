@@ -21,6 +21,10 @@
 #undef SCPI_PARSER_INPUT_BUFFER_LENGTH
 #define SCPI_PARSER_INPUT_BUFFER_LENGTH 256
 
+// room for the SIMUlator commands
+#undef SCPI_PARSER_COMMAND_INDEX_SIZE
+#define SCPI_PARSER_COMMAND_INDEX_SIZE 256
+
 // SIMULATOR SPECIFC CONFIG
 #define SIM_LOAD_MIN 0
 #define SIM_LOAD_DEF 1000.0f
@@ -29,3 +33,47 @@
 #define SIM_TEMP_MIN 0
 #define SIM_TEMP_DEF 25.0f
 #define SIM_TEMP_MAX 120.0f
+
+#define SIM_TIME_RATE_MIN 0
+#define SIM_TIME_RATE_DEF 1.0f
+#define SIM_TIME_RATE_MAX 1000000.0f
+
+// Max. wall clock time (in microseconds) the virtual clock catches up
+// after the main loop was busy.
+#define SIM_TIME_MAX_LAG 100000
+
+#define SIM_LOAD_CURRENT_MIN 0
+#define SIM_LOAD_CURRENT_DEF 0
+#define SIM_LOAD_CURRENT_MAX 100.0f
+
+#define SIM_LOAD_POWER_MIN 0
+#define SIM_LOAD_POWER_DEF 0
+#define SIM_LOAD_POWER_MAX 10000.0f
+
+#define SIM_LOAD_CAPACITANCE_MIN 1E-9f
+#define SIM_LOAD_CAPACITANCE_DEF 1E-3f
+#define SIM_LOAD_CAPACITANCE_MAX 10.0f
+
+// Max. number of resistance values in the load list
+#define SIM_LOAD_LIST_SIZE 16
+
+#define SIM_LOAD_DWELL_MIN 0.001f
+#define SIM_LOAD_DWELL_DEF 0.1f
+#define SIM_LOAD_DWELL_MAX 3600.0f
+
+#define SIM_SLEW_MIN 0.001f
+#define SIM_SLEW_DEF INFINITY
+#define SIM_SLEW_MAX 1000000.0f
+
+// ADC noise amplitude in LSB
+#define SIM_NOISE_MIN 0
+#define SIM_NOISE_DEF 0
+#define SIM_NOISE_MAX 1000.0f
+
+// Heat sink thermal resistance in K/W, 0 disables the thermal model
+#define SIM_THERMAL_RESISTANCE_MIN 0
+#define SIM_THERMAL_RESISTANCE_DEF 0
+#define SIM_THERMAL_RESISTANCE_MAX 100.0f
+
+// Heat sink thermal time constant in seconds
+#define SIM_THERMAL_TIME_CONSTANT 60.0f
@@ -18,9 +18,11 @@
 
 #include "psu.h"
 #include "chips.h"
+#include "load_model.h"
 #include "front_panel/control.h"
 
 #include "main_loop.h"
+#include "batch.h"
 
 // for home directory (see getConfFilePath)
 #ifdef _WIN32
@@ -36,6 +38,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <pwd.h>
 #endif
 
@@ -47,13 +50,29 @@ float temperature[temp_sensor::COUNT];
 
 bool firstTick = true;
 
+static const char *state_dir = 0;
+static int tcp_port = TCP_PORT;
+
+static TimeMode time_mode = TIME_MODE_REAL;
+/// Added to the wall clock in real mode, so time doesn't go back after virtual mode.
+static int64_t time_offset = 0;
+static uint64_t virtual_time = 0;
+static float time_rate = SIM_TIME_RATE_DEF;
+static uint64_t time_step = 0;
+/// Virtual time allowed by the time rate, but not yet given to the ticks.
+static double time_budget = 0;
+static uint64_t time_budget_updated = 0;
+
 void init() {
+    chips::init();
+
     for (int i = 0; i < temp_sensor::COUNT; ++i) {
         temperature[i] = 25.0f;
     }
 }
 
 void tick() {
+    load_model::tick();
     chips::tick();
     psu::tick();
     front_panel::tick();
@@ -74,35 +93,178 @@ float getTemperature(temp_sensor::Type sensor) {
     return temperature[sensor];
 }
 
+void setStateDir(const char *dir) {
+    state_dir = dir;
+}
+
 char *getConfFilePath(char *file_name) {
     static char file_path[1024];
 
     *file_path = '\0';
 
 #ifdef _WIN32
-    if (SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_PROFILE, NULL, 0, file_path))) {
+    if (state_dir) {
+        strcat(file_path, state_dir);
+        _mkdir(file_path);
+        strcat(file_path, "\\");
+    }
+    else if (SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_PROFILE, NULL, 0, file_path))) {
         strcat(file_path, "\\.eez_psu_sim");
         _mkdir(file_path);
         strcat(file_path, "\\");
     }
 #else
-    const char *home_dir = 0;
-    if ((home_dir = getenv("HOME")) == NULL) {
-        home_dir = getpwuid(getuid())->pw_dir;
-    }
-    if (home_dir) {
-        strcat(file_path, home_dir);
-        strcat(file_path, "/.eez_psu_sim");
+    if (state_dir) {
+        strcat(file_path, state_dir);
         mkdir(file_path, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
         strcat(file_path, "/");
     }
+    else {
+        const char *home_dir = 0;
+        if ((home_dir = getenv("HOME")) == NULL) {
+            home_dir = getpwuid(getuid())->pw_dir;
+        }
+        if (home_dir) {
+            strcat(file_path, home_dir);
+            strcat(file_path, "/.eez_psu_sim");
+            mkdir(file_path, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+            strcat(file_path, "/");
+        }
+    }
 #endif
 
     strcat(file_path, file_name);
     return file_path;
 }
 
+void setTcpPort(int port) {
+    tcp_port = port;
+}
+
+int getTcpPort() {
+    return tcp_port;
+}
+
+uint64_t getRealTime() {
+#ifdef _WIN32
+    return GetTickCount64() * 1000;
+#else
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec*(uint64_t)1000000 + tv.tv_usec;
+#endif
+}
+
+void setTimeMode(TimeMode mode) {
+    if (mode == time_mode) {
+        return;
+    }
+
+    // time continues from where it was in the previous mode
+    uint64_t now = getTime();
+    time_mode = mode;
+    setTime(now);
+
+    time_step = 0;
+    time_budget = 0;
+    time_budget_updated = getRealTime();
+}
+
+TimeMode getTimeMode() {
+    return time_mode;
+}
+
+void setTime(uint64_t usec) {
+    if (time_mode == TIME_MODE_VIRTUAL) {
+        virtual_time = usec;
+    }
+    else {
+        time_offset = (int64_t)(usec - getRealTime());
+    }
+}
+
+uint64_t getTime() {
+    if (time_mode == TIME_MODE_VIRTUAL) {
+        return virtual_time;
+    }
+    return getRealTime() + time_offset;
+}
+
+void setTimeRate(float rate) {
+    time_rate = rate;
+    time_budget = 0;
+}
+
+float getTimeRate() {
+    return time_rate;
+}
+
+void stepTime(uint64_t usec) {
+    time_step += usec;
+}
+
+bool isTimeStepPending() {
+    return time_mode == TIME_MODE_VIRTUAL && time_step > 0;
+}
+
+static void updateTimeBudget() {
+    uint64_t now = getRealTime();
+    if (time_rate > 0 && !isinf(time_rate)) {
+        time_budget += (now - time_budget_updated) * (double)time_rate;
+        if (time_budget > SIM_TIME_MAX_LAG * (double)time_rate) {
+            time_budget = SIM_TIME_MAX_LAG * (double)time_rate;
+        }
+    }
+    time_budget_updated = now;
+}
+
+bool advanceTime(uint32_t usec, bool force) {
+    if (time_mode == TIME_MODE_REAL) {
+        return true;
+    }
+
+    updateTimeBudget();
+
+    if (time_step > 0) {
+        if (usec > time_step) {
+            usec = (uint32_t)time_step;
+        }
+        time_step -= usec;
+    }
+    else if (!force && !isinf(time_rate)) {
+        if (time_rate == 0 || time_budget < usec) {
+            return false;
+        }
+        time_budget -= usec;
+    }
+
+    virtual_time += usec;
+    return true;
+}
+
+int getTimeWait(uint32_t usec, bool force) {
+    if (time_mode == TIME_MODE_REAL || force || time_step > 0 || isinf(time_rate)) {
+        return 0;
+    }
+
+    if (time_rate == 0) {
+        return -1;
+    }
+
+    updateTimeBudget();
+    if (time_budget >= usec) {
+        return 0;
+    }
+
+    return (int)ceil((usec - time_budget) / time_rate / 1000);
+}
+
 void exit() {
+    if (batch::isRunning()) {
+        batch::stop();
+        return;
+    }
+
     main_loop_exit();
 }
 
@@ -30,6 +30,7 @@
 #include <string.h>
 #include <math.h>
 #include <stdarg.h>
+#include <stdint.h>
 
 #define PSTR(U) U
 #define strcpy_P strcpy
@@ -55,8 +56,56 @@ void tick();
 void setTemperature(temp_sensor::Type sensor, float value);
 float getTemperature(temp_sensor::Type sensor);
 
+/// Set the directory of the state files (EEPROM, RTC), must be called before init.
+/// By default it is .eez_psu_sim in the home directory.
+void setStateDir(const char *dir);
 char *getConfFilePath(char *file_name);
 
+/// Set the TCP port of the SCPI server, must be called before boot.
+/// By default it is TCP_PORT.
+void setTcpPort(int port);
+int getTcpPort();
+
+/// Simulator clock mode.
+enum TimeMode {
+    /// micros() and millis() follow the wall clock.
+    TIME_MODE_REAL,
+    /// micros() and millis() return virtual time, which advances only
+    /// while the main loop is idle (see advanceTime) or delay is called.
+    TIME_MODE_VIRTUAL
+};
+
+void setTimeMode(TimeMode mode);
+TimeMode getTimeMode();
+
+/// Set the simulator time in microseconds, in virtual mode this is
+/// the starting point of a reproducible run.
+void setTime(uint64_t usec);
+/// Returns the simulator time in microseconds.
+uint64_t getTime();
+/// Returns the wall clock time in microseconds, regardless of the time mode.
+uint64_t getRealTime();
+
+/// Speed of the virtual time relative to the wall clock while the main loop is idle.
+/// 0 stops the clock, so time advances only with stepTime and delay.
+/// INFINITY advances the clock as fast as ticks can be executed.
+void setTimeRate(float rate);
+float getTimeRate();
+
+/// Advance the virtual time by usec. Input is not processed until done.
+void stepTime(uint64_t usec);
+bool isTimeStepPending();
+
+/// Called by the main loop before the tick when there is no input to process.
+/// In virtual mode advances the clock by usec (at most) if allowed by the time rate
+/// or pending step and returns true if time was advanced. If force is true the clock
+/// advances even if stopped, this is used while input waits for power up to finish.
+/// In real mode always returns true.
+bool advanceTime(uint32_t usec, bool force);
+/// Returns the number of wall clock milliseconds the main loop can wait
+/// before advanceTime succeeds, or -1 if the clock is stopped.
+int getTimeWait(uint32_t usec, bool force);
+
 void exit();
 
 }
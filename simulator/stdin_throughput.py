@@ -0,0 +1,49 @@
+'''
+EEZ PSU Firmware
+Copyright (C) 2015 Envox d.o.o.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+'''
+
+# Measures how fast the simulator consumes SCPI script piped into stdin.
+# Simulator is run twice, with empty input and with the script, and the
+# difference in run time is taken as the time needed to process the script.
+#
+# usage: python stdin_throughput.py [simulator] [lines]
+
+import subprocess
+import sys
+import time
+
+simulator = sys.argv[1] if len(sys.argv) > 1 else './eez_psu_sim'
+num_lines = int(sys.argv[2]) if len(sys.argv) > 2 else 100000
+
+lines = []
+for i in range(num_lines):
+    lines.append('VOLT %.2f;CURR %.2f\n' % ((i % 400) / 100.0, (i % 300) / 100.0))
+script = ''.join(lines).encode('ascii')
+
+def run(data):
+    start = time.time()
+    process = subprocess.Popen([simulator], stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    output = process.communicate(data + b'SYST:ERR?\n')[0]
+    return time.time() - start, output.decode(errors='replace').strip().splitlines()
+
+startup, _ = run(b'')
+elapsed, output = run(script)
+elapsed -= startup
+
+print('startup %.3f s, SYST:ERR? -> %s' % (startup, output[-1] if output else ''))
+print('%d lines, %d bytes in %.3f s' % (num_lines, len(script), elapsed))
+print('%.0f lines/s, %.0f bytes/s' % (num_lines / elapsed, len(script) / elapsed))